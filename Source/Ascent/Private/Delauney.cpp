@@ -1,6 +1,618 @@
 #include "Delauney.h"
+#include "Math/VectorRegister.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
 
 
+// Index of a point along a Hilbert curve over a 65536 x 65536 grid. Inserting in this order keeps each
+// point close to the last one, so the walk in Locate only crosses a handful of triangles.
+static uint32 GetHilbertIndex(uint32 InX, uint32 InY) {
+	uint32 Index = 0;
+	for (uint32 S = 1u << 15; S > 0; S >>= 1) {
+		const uint32 RX = (InX & S) > 0;
+		const uint32 RY = (InY & S) > 0;
+		Index += S * S * ((3 * RX) ^ RY);
+
+		// Rotate the quadrant
+		if (RY == 0) {
+			if (RX == 1) {
+				InX = S - 1 - InX;
+				InY = S - 1 - InY;
+			}
+			Swap(InX, InY);
+		}
+	}
+	return Index;
+}
+
+
+void FDTriangulation::Reset(double MinX, double MinY, double MaxX, double MaxY, int32 ConvexMultiplier, int32 ExpectedVertices) {
+	X.Reset(ExpectedVertices + NumSuperVertices);
+	Y.Reset(ExpectedVertices + NumSuperVertices);
+	Triangles.Reset((ExpectedVertices * 2 + 1) * 3);
+	HalfEdges.Reset((ExpectedVertices * 2 + 1) * 3);
+	CircumX.Reset(ExpectedVertices * 2 + 1);
+	CircumY.Reset(ExpectedVertices * 2 + 1);
+	CircumRadiusSqr.Reset(ExpectedVertices * 2 + 1);
+	Marks.Reset(ExpectedVertices * 2 + 1);
+	VertexHalfEdges.Reset(ExpectedVertices + NumSuperVertices);
+	FreeTriangles.Reset();
+	Stamp = 0;
+
+	// About two expected vertices per locate cell
+	LocateGridSize = FMath::Clamp(FMath::CeilToInt(FMath::Sqrt(ExpectedVertices / 2.0)), 1, 1024);
+	LocateGridMinX = MinX;
+	LocateGridMinY = MinY;
+	LocateGridCellSize = FMath::Max(FMath::Max(MaxX - MinX, MaxY - MinY) / LocateGridSize, UE_DOUBLE_SMALL_NUMBER);
+	LocateGrid.Init(INDEX_NONE, LocateGridSize * LocateGridSize);
+
+	const double Dx = (MaxX - MinX) * ConvexMultiplier;
+	const double Dy = (MaxY - MinY) * ConvexMultiplier;
+	const double DeltaMax = FMath::Max(FMath::Max(Dx, Dy), 1.0);
+	const double MidX = (MinX + MaxX) * 0.5;
+	const double MidY = (MinY + MaxY) * 0.5;
+
+	// Super triangle, counter-clockwise
+	AddVertex(MidX - 2.0 * DeltaMax, MidY - DeltaMax);
+	AddVertex(MidX + 2.0 * DeltaMax, MidY - DeltaMax);
+	AddVertex(MidX, MidY + 2.0 * DeltaMax);
+	LastTriangle = AddTriangle(0, 1, 2);
+	for (int32 i = 0; i < NumSuperVertices; i++) {
+		VertexHalfEdges[i] = LastTriangle * 3 + i;
+	}
+}
+
+int32 FDTriangulation::AddVertex(double InX, double InY) {
+	X.Add(InX);
+	VertexHalfEdges.Add(INDEX_NONE);
+	return Y.Add(InY);
+}
+
+int32 FDTriangulation::GetLocateCell(double InX, double InY) const {
+	const int32 CellX = FMath::Clamp(FMath::FloorToInt((InX - LocateGridMinX) / LocateGridCellSize), 0, LocateGridSize - 1);
+	const int32 CellY = FMath::Clamp(FMath::FloorToInt((InY - LocateGridMinY) / LocateGridCellSize), 0, LocateGridSize - 1);
+	return CellY * LocateGridSize + CellX;
+}
+
+int32 FDTriangulation::GetLocateHint(double InX, double InY) const {
+	const int32 Vertex = LocateGrid[GetLocateCell(InX, InY)];
+	if (Vertex == INDEX_NONE || VertexHalfEdges[Vertex] == INDEX_NONE) {
+		return INDEX_NONE;
+	}
+	return VertexHalfEdges[Vertex] / 3;
+}
+
+void FDTriangulation::LinkHalfEdges(int32 E, int32 Twin) {
+	HalfEdges[E] = Twin;
+	if (Twin != INDEX_NONE) {
+		HalfEdges[Twin] = E;
+	}
+}
+
+int32 FDTriangulation::AddTriangle(int32 V1, int32 V2, int32 V3) {
+	int32 Triangle;
+	if (FreeTriangles.Num() > 0) {
+		Triangle = FreeTriangles.Pop(false);
+	}
+	else {
+		Triangle = Marks.Add(0);
+		Triangles.AddUninitialized(3);
+		HalfEdges.AddUninitialized(3);
+		CircumX.AddUninitialized();
+		CircumY.AddUninitialized();
+		CircumRadiusSqr.AddUninitialized();
+	}
+
+	Triangles[Triangle * 3] = V1;
+	Triangles[Triangle * 3 + 1] = V2;
+	Triangles[Triangle * 3 + 2] = V3;
+	HalfEdges[Triangle * 3] = INDEX_NONE;
+	HalfEdges[Triangle * 3 + 1] = INDEX_NONE;
+	HalfEdges[Triangle * 3 + 2] = INDEX_NONE;
+
+	// Circumcenter relative to V1 keeps the products small
+	const double BX = X[V2] - X[V1];
+	const double BY = Y[V2] - Y[V1];
+	const double CX = X[V3] - X[V1];
+	const double CY = Y[V3] - Y[V1];
+	const double B = BX * BX + BY * BY;
+	const double C = CX * CX + CY * CY;
+	const double D = (BX * CY - BY * CX) * 2.0;
+
+	if (D != 0.0) {
+		const double UX = (CY * B - BY * C) / D;
+		const double UY = (BX * C - CX * B) / D;
+		CircumX[Triangle] = X[V1] + UX;
+		CircumY[Triangle] = Y[V1] + UY;
+		CircumRadiusSqr[Triangle] = UX * UX + UY * UY;
+	}
+	else {
+		// A flat triangle can't be Delaunay, let the next insertion nearby replace it
+		CircumX[Triangle] = X[V1];
+		CircumY[Triangle] = Y[V1];
+		CircumRadiusSqr[Triangle] = UE_DOUBLE_BIG_NUMBER;
+	}
+
+	return Triangle;
+}
+
+double FDTriangulation::Orient(int32 V1, int32 V2, double InX, double InY) const {
+	// Positive when the position is left of V1 -> V2
+	return (X[V2] - X[V1]) * (InY - Y[V1]) - (Y[V2] - Y[V1]) * (InX - X[V1]);
+}
+
+bool FDTriangulation::IsInCircle(int32 V1, int32 V2, int32 V3, double InX, double InY) const {
+	const double ADX = X[V1] - InX;
+	const double ADY = Y[V1] - InY;
+	const double BDX = X[V2] - InX;
+	const double BDY = Y[V2] - InY;
+	const double CDX = X[V3] - InX;
+	const double CDY = Y[V3] - InY;
+
+	const double AD = ADX * ADX + ADY * ADY;
+	const double BD = BDX * BDX + BDY * BDY;
+	const double CD = CDX * CDX + CDY * CDY;
+
+	return (ADX * (BDY * CD - BD * CDY)
+		- ADY * (BDX * CD - BD * CDX)
+		+ AD * (BDX * CDY - BDY * CDX)
+		) > 0.0;
+}
+
+uint64 FDTriangulation::FindContainingCirclesScalar(const double* InCircumX, const double* InCircumY, const double* InRadiusSqr, int32 Num, double InX, double InY) {
+	uint64 Hits = 0;
+	for (int32 i = 0; i < Num; i++) {
+		const double DX = InCircumX[i] - InX;
+		const double DY = InCircumY[i] - InY;
+		if (DX * DX + DY * DY < InRadiusSqr[i]) {
+			Hits |= 1ull << i;
+		}
+	}
+	return Hits;
+}
+
+uint64 FDTriangulation::FindContainingCircles(const double* InCircumX, const double* InCircumY, const double* InRadiusSqr, int32 Num, double InX, double InY) {
+	check(Num <= 64);
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+	// Four circles per iteration. VectorRegister4Double is a single AVX register when the target enables AVX,
+	// and a pair of SSE2 registers otherwise.
+	const VectorRegister4Double PX = MakeVectorRegisterDouble(InX, InX, InX, InX);
+	const VectorRegister4Double PY = MakeVectorRegisterDouble(InY, InY, InY, InY);
+
+	uint64 Hits = 0;
+	int32 i = 0;
+	for (; i + 4 <= Num; i += 4) {
+		const VectorRegister4Double DX = VectorSubtract(VectorLoad(InCircumX + i), PX);
+		const VectorRegister4Double DY = VectorSubtract(VectorLoad(InCircumY + i), PY);
+
+		// Multiply and add separately so results match the scalar path bit for bit
+		const VectorRegister4Double DistSqr = VectorAdd(VectorMultiply(DX, DX), VectorMultiply(DY, DY));
+		Hits |= (uint64)VectorMaskBits(VectorCompareLT(DistSqr, VectorLoad(InRadiusSqr + i))) << i;
+	}
+
+	return Hits | (FindContainingCirclesScalar(InCircumX + i, InCircumY + i, InRadiusSqr + i, Num - i, InX, InY) << i);
+#else
+	return FindContainingCirclesScalar(InCircumX, InCircumY, InRadiusSqr, Num, InX, InY);
+#endif
+}
+
+int32 FDTriangulation::Locate(double InX, double InY, int32 StartTriangle) const {
+	int32 Triangle = (StartTriangle != INDEX_NONE && IsTriangleAlive(StartTriangle)) ? StartTriangle : LastTriangle;
+	const int32 MaxSteps = GetNumTriangleSlots();
+
+	for (int32 Step = 0; Step < MaxSteps; Step++) {
+		bool bInside = true;
+		for (int32 i = 0; i < 3; i++) {
+			// Rotate the first edge tested so degenerate input can't trap the walk in a cycle
+			const int32 E = Triangle * 3 + (i + Step) % 3;
+			if (Orient(Triangles[E], Triangles[NextHalfEdge(E)], InX, InY) < 0.0) {
+				if (HalfEdges[E] == INDEX_NONE) {
+					return INDEX_NONE;
+				}
+				Triangle = HalfEdges[E] / 3;
+				bInside = false;
+				break;
+			}
+		}
+
+		if (bInside) {
+			return Triangle;
+		}
+	}
+
+	// The walk didn't converge, fall back to checking every triangle
+	for (int32 i = 0; i < GetNumTriangleSlots(); i++) {
+		if (IsTriangleAlive(i)
+			&& Orient(Triangles[i * 3], Triangles[i * 3 + 1], InX, InY) >= 0.0
+			&& Orient(Triangles[i * 3 + 1], Triangles[i * 3 + 2], InX, InY) >= 0.0
+			&& Orient(Triangles[i * 3 + 2], Triangles[i * 3], InX, InY) >= 0.0
+			) {
+			return i;
+		}
+	}
+	return INDEX_NONE;
+}
+
+bool FDTriangulation::InsertVertex(int32 Vertex, FDEdgeChanges* OutChanges) {
+	const double PX = X[Vertex];
+	const double PY = Y[Vertex];
+
+	const int32 Start = Locate(PX, PY, GetLocateHint(PX, PY));
+	if (Start == INDEX_NONE) {
+		UE_LOG(LogActor, Error, TEXT("Point (%f, %f) is outside the super triangle."), PX, PY);
+		return false;
+	}
+
+	for (int32 i = 0; i < 3; i++) {
+		const int32 Corner = Triangles[Start * 3 + i];
+		if (X[Corner] == PX && Y[Corner] == PY) {
+			return false;
+		}
+	}
+
+	// Grow the cavity outwards from the containing triangle one layer at a time. It is always connected, so only
+	// neighbours of triangles already in it need testing, and each layer's neighbours are tested as one packed block.
+	const uint32 BadMark = ++Stamp * 2;
+	const uint32 KeptMark = BadMark + 1;
+
+	Cavity.Reset();
+	Cavity.Add(Start);
+	Marks[Start] = BadMark;
+
+	int32 LayerStart = 0;
+	while (LayerStart < Cavity.Num()) {
+		const int32 LayerEnd = Cavity.Num();
+
+		Candidates.Reset();
+		CandidateX.Reset();
+		CandidateY.Reset();
+		CandidateRadiusSqr.Reset();
+		for (int32 c = LayerStart; c < LayerEnd; c++) {
+			for (int32 i = 0; i < 3; i++) {
+				const int32 Twin = HalfEdges[Cavity[c] * 3 + i];
+				if (Twin == INDEX_NONE) continue;
+
+				// Kept until the block test says otherwise, which also stops it being gathered twice
+				const int32 Neighbour = Twin / 3;
+				if (Marks[Neighbour] == BadMark || Marks[Neighbour] == KeptMark) continue;
+				Marks[Neighbour] = KeptMark;
+
+				Candidates.Add(Neighbour);
+				CandidateX.Add(CircumX[Neighbour]);
+				CandidateY.Add(CircumY[Neighbour]);
+				CandidateRadiusSqr.Add(CircumRadiusSqr[Neighbour]);
+			}
+		}
+		LayerStart = LayerEnd;
+
+		for (int32 Block = 0; Block < Candidates.Num(); Block += 64) {
+			uint64 Hits = FindContainingCircles(
+				&CandidateX[Block]
+				, &CandidateY[Block]
+				, &CandidateRadiusSqr[Block]
+				, FMath::Min(Candidates.Num() - Block, 64)
+				, PX
+				, PY
+			);
+
+			while (Hits != 0) {
+				const int32 Neighbour = Candidates[Block + FMath::CountTrailingZeros64(Hits)];
+				Marks[Neighbour] = BadMark;
+				Cavity.Add(Neighbour);
+				Hits &= Hits - 1;
+			}
+		}
+	}
+
+	// Collect the cavity boundary. Rounding can leave an edge the new vertex can't see, which would make a flipped
+	// triangle, so pull the triangle behind it into the cavity and try again.
+	bool bBoundaryVisible = false;
+	while (!bBoundaryVisible) {
+		bBoundaryVisible = true;
+		Boundary.Reset();
+
+		for (int32 c = 0; c < Cavity.Num() && bBoundaryVisible; c++) {
+			for (int32 i = 0; i < 3; i++) {
+				const int32 E = Cavity[c] * 3 + i;
+				const int32 Twin = HalfEdges[E];
+				if (Twin != INDEX_NONE && Marks[Twin / 3] == BadMark) continue;
+
+				const int32 V1 = Triangles[E];
+				const int32 V2 = Triangles[NextHalfEdge(E)];
+				if (Twin != INDEX_NONE && Orient(V1, V2, PX, PY) <= 0.0) {
+					Marks[Twin / 3] = BadMark;
+					Cavity.Add(Twin / 3);
+					bBoundaryVisible = false;
+					break;
+				}
+
+				Boundary.Add({ V1, V2, Twin });
+			}
+		}
+	}
+
+	if (OutChanges) {
+		// Edges inside the cavity go, and every boundary vertex gets an edge to the new vertex
+		OutChanges->Reset();
+		for (int32 Triangle : Cavity) {
+			for (int32 i = 0; i < 3; i++) {
+				const int32 E = Triangle * 3 + i;
+				const int32 Twin = HalfEdges[E];
+				if (Twin != INDEX_NONE && E < Twin && Marks[Twin / 3] == BadMark) {
+					OutChanges->Removed.Add(FDEdgeChanges::MakeEdge(Triangles[E], Triangles[NextHalfEdge(E)]));
+				}
+			}
+		}
+		for (const FBoundaryEdge& Edge : Boundary) {
+			OutChanges->Added.Add(FDEdgeChanges::MakeEdge(Edge.V1, Vertex));
+		}
+	}
+
+	// Replace the cavity with a fan around the new vertex, reusing the cavity's slots
+	for (int32 Triangle : Cavity) {
+		Triangles[Triangle * 3] = INDEX_NONE;
+		FreeTriangles.Add(Triangle);
+	}
+
+	// The boundary is a closed loop, so each fan triangle's V2 is exactly one other triangle's V1. Find it through a
+	// table at most half full, cleared and reused every insertion, so stitching is linear and never allocates once warm.
+	const int32 TableSize = FMath::RoundUpToPowerOfTwo(Boundary.Num() * 2);
+	const uint32 Shift = 32 - FMath::FloorLog2(TableSize);
+	const uint32 Mask = TableSize - 1;
+	if (FanKeys.Num() < TableSize) {
+		FanKeys.SetNumUninitialized(TableSize);
+		FanTriangles.SetNumUninitialized(TableSize);
+	}
+	FMemory::Memset(FanKeys.GetData(), 0xff, TableSize * sizeof(int32));
+
+	auto GetSlot = [Shift](int32 Key) {
+		return ((uint32)Key * 2654435761u) >> Shift;
+	};
+
+	Fan.Reset();
+	for (const FBoundaryEdge& Edge : Boundary) {
+		const int32 Triangle = AddTriangle(Edge.V1, Edge.V2, Vertex);
+		LinkHalfEdges(Triangle * 3, Edge.Twin);
+		VertexHalfEdges[Edge.V1] = Triangle * 3;
+		Fan.Add(Triangle);
+
+		uint32 Slot = GetSlot(Edge.V1);
+		while (FanKeys[Slot] != INDEX_NONE) {
+			Slot = (Slot + 1) & Mask;
+		}
+		FanKeys[Slot] = Edge.V1;
+		FanTriangles[Slot] = Triangle;
+	}
+
+	// Stitch the fan together: V2 -> Vertex of each triangle is the twin of Vertex -> V1 on the next
+	for (int32 Triangle : Fan) {
+		const int32 V2 = Triangles[Triangle * 3 + 1];
+		uint32 Slot = GetSlot(V2);
+		while (FanKeys[Slot] != V2) {
+			Slot = (Slot + 1) & Mask;
+		}
+
+		LinkHalfEdges(Triangle * 3 + 1, FanTriangles[Slot] * 3 + 2);
+	}
+	LastTriangle = Fan.Last();
+	VertexHalfEdges[Vertex] = LastTriangle * 3 + 2;
+	LocateGrid[GetLocateCell(PX, PY)] = Vertex;
+
+	return true;
+}
+
+int32 FDTriangulation::InsertPoint(double InX, double InY, FDEdgeChanges* OutChanges) {
+	const int32 Vertex = AddVertex(InX, InY);
+	return InsertVertex(Vertex, OutChanges) ? Vertex : INDEX_NONE;
+}
+
+bool FDTriangulation::RemoveVertex(int32 Vertex, FDEdgeChanges* OutChanges) {
+	if (IsSuperVertex(Vertex) || VertexHalfEdges[Vertex] == INDEX_NONE) {
+		return false;
+	}
+
+	// Walk the triangles around the vertex counter-clockwise. The edges opposite it form the hole's boundary.
+	Ring.Reset();
+	RingTwins.Reset();
+	Cavity.Reset();
+
+	const int32 Start = VertexHalfEdges[Vertex];
+	int32 E = Start;
+	do {
+		const int32 Opposite = NextHalfEdge(E);
+		Cavity.Add(E / 3);
+		Ring.Add(Triangles[Opposite]);
+		RingTwins.Add(HalfEdges[Opposite]);
+		E = HalfEdges[PrevHalfEdge(E)];
+	} while (E != Start && E != INDEX_NONE);
+
+	// Every real vertex is inside the super triangle, so its ring is always closed
+	check(E == Start);
+
+	if (OutChanges) {
+		OutChanges->Reset();
+		for (int32 RingVertex : Ring) {
+			OutChanges->Removed.Add(FDEdgeChanges::MakeEdge(Vertex, RingVertex));
+		}
+	}
+
+	VertexHalfEdges[Vertex] = INDEX_NONE;
+	const int32 Cell = GetLocateCell(X[Vertex], Y[Vertex]);
+	if (LocateGrid[Cell] == Vertex) {
+		LocateGrid[Cell] = Ring[0];
+	}
+
+	for (int32 Triangle : Cavity) {
+		Triangles[Triangle * 3] = INDEX_NONE;
+		FreeTriangles.Add(Triangle);
+	}
+
+	// Clip ears off the hole. An ear whose circle holds none of the ring's vertices is a Delaunay triangle of the ring,
+	// and the hole always has at least two of them, so the clipped triangles are the Delaunay retriangulation.
+	RingVertices = Ring;
+	while (Ring.Num() > 3) {
+		const int32 NRing = Ring.Num();
+		int32 Ear = INDEX_NONE;
+		int32 FallbackEar = INDEX_NONE;
+
+		for (int32 j = 0; j < NRing && Ear == INDEX_NONE; j++) {
+			const int32 V1 = Ring[(j + NRing - 1) % NRing];
+			const int32 V2 = Ring[j];
+			const int32 V3 = Ring[(j + 1) % NRing];
+			if (Orient(V1, V2, X[V3], Y[V3]) <= 0.0) continue;
+
+			if (FallbackEar == INDEX_NONE) {
+				FallbackEar = j;
+			}
+
+			bool bEmpty = true;
+			for (int32 Other : RingVertices) {
+				if (Other != V1 && Other != V2 && Other != V3 && IsInCircle(V1, V2, V3, X[Other], Y[Other])) {
+					bEmpty = false;
+					break;
+				}
+			}
+
+			if (bEmpty) {
+				Ear = j;
+			}
+		}
+
+		// Only cocircular rounding can leave no empty ear, any convex one keeps the mesh valid
+		if (Ear == INDEX_NONE) {
+			Ear = FallbackEar != INDEX_NONE ? FallbackEar : 0;
+		}
+
+		const int32 Prev = (Ear + NRing - 1) % NRing;
+		const int32 Next = (Ear + 1) % NRing;
+		const int32 Triangle = AddTriangle(Ring[Prev], Ring[Ear], Ring[Next]);
+		LinkHalfEdges(Triangle * 3, RingTwins[Prev]);
+		LinkHalfEdges(Triangle * 3 + 1, RingTwins[Ear]);
+		VertexHalfEdges[Ring[Prev]] = Triangle * 3;
+		VertexHalfEdges[Ring[Ear]] = Triangle * 3 + 1;
+		VertexHalfEdges[Ring[Next]] = Triangle * 3 + 2;
+
+		if (OutChanges) {
+			OutChanges->Added.Add(FDEdgeChanges::MakeEdge(Ring[Prev], Ring[Next]));
+		}
+
+		// The new diagonal replaces the ear's two edges on the hole
+		RingTwins[Prev] = Triangle * 3 + 2;
+		Ring.RemoveAt(Ear, 1, false);
+		RingTwins.RemoveAt(Ear, 1, false);
+	}
+
+	const int32 Triangle = AddTriangle(Ring[0], Ring[1], Ring[2]);
+	for (int32 i = 0; i < 3; i++) {
+		LinkHalfEdges(Triangle * 3 + i, RingTwins[i]);
+		VertexHalfEdges[Ring[i]] = Triangle * 3 + i;
+	}
+	LastTriangle = Triangle;
+
+	return true;
+}
+
+void FDTriangulation::InsertPoints(const TArray<FDPoint>& InPoints) {
+	const int32 NPoints = InPoints.Num();
+	const int32 FirstVertex = X.Num();
+	if (NPoints == 0) return;
+
+	float MinX = InPoints[0].X;
+	float MinY = InPoints[0].Y;
+	float MaxX = MinX;
+	float MaxY = MinY;
+	for (const FDPoint& Point : InPoints) {
+		MinX = FMath::Min(MinX, Point.X);
+		MaxX = FMath::Max(MaxX, Point.X);
+		MinY = FMath::Min(MinY, Point.Y);
+		MaxY = FMath::Max(MaxY, Point.Y);
+		AddVertex(Point.X, Point.Y);
+	}
+
+	// Sort by Hilbert index, keeping the point index in the low bits
+	const double ScaleX = 65535.0 / FMath::Max(MaxX - MinX, 1.f);
+	const double ScaleY = 65535.0 / FMath::Max(MaxY - MinY, 1.f);
+	TArray<uint64> Order;
+	Order.SetNumUninitialized(NPoints);
+	for (int32 i = 0; i < NPoints; i++) {
+		const uint32 HX = (uint32)((InPoints[i].X - MinX) * ScaleX);
+		const uint32 HY = (uint32)((InPoints[i].Y - MinY) * ScaleY);
+		Order[i] = ((uint64)GetHilbertIndex(HX, HY) << 32) | (uint32)i;
+	}
+	Order.Sort();
+
+	for (uint64 Key : Order) {
+		InsertVertex(FirstVertex + (int32)(Key & 0xffffffff));
+	}
+}
+
+
+void FDTriangulation::BuildMesh(FDMesh& OutMesh) const {
+	const int32 NVertices = X.Num() - NumSuperVertices;
+	OutMesh.X.SetNumUninitialized(NVertices);
+	OutMesh.Y.SetNumUninitialized(NVertices);
+	for (int32 i = 0; i < NVertices; i++) {
+		OutMesh.X[i] = X[i + NumSuperVertices];
+		OutMesh.Y[i] = Y[i + NumSuperVertices];
+	}
+
+	// Map each kept triangle slot to its compacted index
+	TArray<int32> Remap;
+	Remap.Init(INDEX_NONE, GetNumTriangleSlots());
+	int32 NTriangles = 0;
+	for (int32 i = 0; i < GetNumTriangleSlots(); i++) {
+		if (IsTriangleAlive(i)
+			&& !IsSuperVertex(Triangles[i * 3])
+			&& !IsSuperVertex(Triangles[i * 3 + 1])
+			&& !IsSuperVertex(Triangles[i * 3 + 2])
+			) {
+			Remap[i] = NTriangles++;
+		}
+	}
+
+	OutMesh.Triangles.SetNumUninitialized(NTriangles * 3);
+	OutMesh.HalfEdges.SetNumUninitialized(NTriangles * 3);
+	OutMesh.VertexHalfEdges.Init(INDEX_NONE, NVertices);
+
+	for (int32 i = 0; i < GetNumTriangleSlots(); i++) {
+		if (Remap[i] == INDEX_NONE) continue;
+
+		for (int32 j = 0; j < 3; j++) {
+			const int32 E = Remap[i] * 3 + j;
+			const int32 Twin = HalfEdges[i * 3 + j];
+			const int32 Vertex = Triangles[i * 3 + j] - NumSuperVertices;
+
+			OutMesh.Triangles[E] = Vertex;
+			OutMesh.HalfEdges[E] = (Twin != INDEX_NONE && Remap[Twin / 3] != INDEX_NONE) ? Remap[Twin / 3] * 3 + Twin % 3 : INDEX_NONE;
+
+			// Prefer hull edges so neighbour iteration can start from one end of the fan
+			if (OutMesh.VertexHalfEdges[Vertex] == INDEX_NONE || OutMesh.HalfEdges[E] == INDEX_NONE) {
+				OutMesh.VertexHalfEdges[Vertex] = E;
+			}
+		}
+	}
+}
+
+
+// Numbers the points by index and gets the min / max dimensions of the grid containing them.
+static void PreparePoints(TArray<FDPoint>& InPoints, float& OutMinX, float& OutMinY, float& OutMaxX, float& OutMaxY) {
+	OutMinX = InPoints[0].X;
+	OutMinY = InPoints[0].Y;
+	OutMaxX = OutMinX;
+	OutMaxY = OutMinY;
+
+	for (int32 i = 0; i < InPoints.Num(); i++) {
+		FDPoint& Point = InPoints[i];
+		Point.Id = i;
+
+		OutMinX = FMath::Min(OutMinX, Point.X);
+		OutMaxX = FMath::Max(OutMaxX, Point.X);
+
+		OutMinY = FMath::Min(OutMinY, Point.Y);
+		OutMaxY = FMath::Max(OutMaxY, Point.Y);
+	}
+}
+
 TArray<FDTriangle> FDelaunay::Triangulate(TArray<FDPoint>& InPoints, int32 InDelaunayConvexMultiplier) const {
 	TArray<FDTriangle> Triangles;
 	int32 NPoints = InPoints.Num();
@@ -13,113 +625,374 @@ TArray<FDTriangle> FDelaunay::Triangulate(TArray<FDPoint>& InPoints, int32 InDel
 		return Triangles;
 	}
 
-	// Start (Bowyer Watson) Delaunay triangulation.
+	const FDMesh Mesh = TriangulateMesh(InPoints, InDelaunayConvexMultiplier);
 
-	// Get the max amount of expected triangles.
-	int32 TrMax = NPoints * 4;
-	// Get the min / max dimensions of the grid containing the points.
-	float MinX = InPoints[0].X;
-	float MinY = InPoints[0].Y;
-	float MaxX = MinX;
-	float MaxY = MinY;
+	Triangles.Reserve(Mesh.GetNumTriangles());
+	for (int32 i = 0; i < Mesh.GetNumTriangles(); i++) {
+		Triangles.Add(FDTriangle(
+			InPoints[Mesh.Triangles[i * 3]]
+			, InPoints[Mesh.Triangles[i * 3 + 1]]
+			, InPoints[Mesh.Triangles[i * 3 + 2]]
+		));
+	}
 
-	for (int32 i = 0; i < NPoints; i++) {
-		FDPoint& Point = InPoints[i];
-		Point.Id = i;
+	return Triangles;
+}
 
-		MinX = FMath::Min(MinX, Point.X);
-		MaxX = FMath::Max(MaxX, Point.X);
+FDMesh FDelaunay::TriangulateMesh(TArray<FDPoint>& InPoints, int32 InDelaunayConvexMultiplier) const {
+	FDMesh Mesh;
+	int32 NPoints = InPoints.Num();
+	if (NPoints < 3) {
+		UE_LOG(LogActor, Error, TEXT("Triangulate needs at least 3 points."));
+		return Mesh;
+	}
 
-		MinY = FMath::Min(MinY, Point.Y);
-		MaxY = FMath::Max(MaxY, Point.Y);
+	float MinX, MinY, MaxX, MaxY;
+	PreparePoints(InPoints, MinX, MinY, MaxX, MaxY);
+
+	FDTriangulation Triangulation;
+	Triangulation.Reset(MinX, MinY, MaxX, MaxY, InDelaunayConvexMultiplier, NPoints);
+	Triangulation.InsertPoints(InPoints);
+	Triangulation.BuildMesh(Mesh);
+
+	return Mesh;
+}
+
+FDMesh FDelaunay::TriangulateMeshParallel(TArray<FDPoint>& InPoints, int32 InDelaunayConvexMultiplier, int32 InNumStrips) const {
+	// Below this a strip costs more to merge than to triangulate
+	const int32 MIN_POINTS_PER_STRIP = 2048;
+
+	const int32 NPoints = InPoints.Num();
+	const int32 NStrips = FMath::Min(
+		InNumStrips > 0 ? InNumStrips : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1
+		, NPoints / MIN_POINTS_PER_STRIP
+	);
+	if (NStrips < 2) {
+		return TriangulateMesh(InPoints, InDelaunayConvexMultiplier);
 	}
 
-	float Dx = ((MaxX - MinX) * InDelaunayConvexMultiplier);
-	float Dy = ((MaxY - MinY) * InDelaunayConvexMultiplier);
-	float DeltaMax = FMath::Max(Dx, Dy);
-	float MidX = (MinX + MaxX) * 0.5f;
-	float MidY = (MinY + MaxY) * 0.5f;
+	float MinX, MinY, MaxX, MaxY;
+	PreparePoints(InPoints, MinX, MinY, MaxX, MaxY);
 
-	// Add Super Triangle. For simplicity add the generated Super points on top of the point array. 
-	FDPoint SuP1 = FDPoint(MidX - 2.f * DeltaMax, MidY - DeltaMax, NPoints);
-	FDPoint SuP2 = FDPoint(MidX, MidY + 2.f * DeltaMax, NPoints + 1);
-	FDPoint SuP3 = FDPoint(MidX + 2.f * DeltaMax, MidY - DeltaMax, NPoints + 2);
-	InPoints.EmplaceAt(SuP1.Id, SuP1);
-	InPoints.EmplaceAt(SuP2.Id, SuP2);
-	InPoints.EmplaceAt(SuP3.Id, SuP3);
-	Triangles.Add(FDTriangle(SuP1, SuP2, SuP3));
+	// Every strip, and the seam, uses the same super triangle as the serial path, so they are all pieces of the same
+	// Delaunay triangulation.
+	struct FStrip {
 
-	// Use NPoints instead of InPoints.Num() when looping over the original points, to not include the initial super points.
+		FDTriangulation Triangulation;
+
+		TArray<FDPoint> Points;
+
+		// Points with X in [MinX, MaxX) belong to the strip
+		double MinX;
+
+		double MaxX;
+
+		// Whether each triangle slot's circumcircle lies entirely within the strip
+		TArray<bool> Final;
+
+		// Slots of the final triangles that don't use the super triangle, in output order
+		TArray<int32> Kept;
+
+		// Points used by triangles that aren't final
+		TArray<FDPoint> SeamPoints;
+	};
+
+	// Split into vertical strips with the same number of points, never splitting points that share an X
+	TArray<int32> SortedByX;
+	SortedByX.SetNumUninitialized(NPoints);
 	for (int32 i = 0; i < NPoints; i++) {
-		TArray<FDEdge> Edges;
-
-		// For each point, look which triangles their CircumCircle contains this point
-		// , in which case we don't want the triangle because it is not a Delaunay triangle.
-		for (int32 j = Triangles.Num() - 1; j >= 0; j--) {
-			FDTriangle CurTriangle = Triangles[j];
-			if (CurTriangle.IsInCircumCircle(InPoints[i])) {
-
-				//// For each edge, add if not yet present by IsSimilar
-				//auto AddEdgeIfNotSimilar = [&Edges](const FDEdge& InEdge) {
-				//	bool bAdd = true;
-				//	for (const FDEdge& EdgeX : Edges) {
-				//		if (EdgeX.IsSimilar(InEdge)) {
-				//			bAdd = false;
-				//			break;
-				//		}
-				//	}
-				//	if (bAdd) {
-				//		Edges.Add(InEdge);
-				//	}
-				//	};
-				//AddEdgeIfNotSimilar(CurTriangle.E1);
-				//AddEdgeIfNotSimilar(CurTriangle.E2);
-				//AddEdgeIfNotSimilar(CurTriangle.E3);
-
-				Edges.Add(CurTriangle.E1);
-				Edges.Add(CurTriangle.E2);
-				Edges.Add(CurTriangle.E3);
-
-				// Remove the unwanted triangle
-				Triangles.RemoveAt(j);
-			}
+		SortedByX[i] = i;
+	}
+	SortedByX.Sort([&InPoints](int32 A, int32 B) {
+		return InPoints[A].X < InPoints[B].X || (InPoints[A].X == InPoints[B].X && A < B);
+	});
+
+	TArray<int32> StripStarts;
+	StripStarts.Add(0);
+	for (int32 i = 1; i < NStrips; i++) {
+		int32 Start = FMath::Max((int32)((int64)NPoints * i / NStrips), StripStarts.Last() + 1);
+		while (Start < NPoints && InPoints[SortedByX[Start]].X == InPoints[SortedByX[Start - 1]].X) {
+			Start++;
+		}
+		if (Start < NPoints) {
+			StripStarts.Add(Start);
 		}
+	}
+	StripStarts.Add(NPoints);
+
+	TArray<FStrip> Strips;
+	Strips.SetNum(StripStarts.Num() - 1);
+
+	ParallelFor(Strips.Num(), [&](int32 StripIndex) {
+		FStrip& Strip = Strips[StripIndex];
+		const int32 Start = StripStarts[StripIndex];
+		const int32 End = StripStarts[StripIndex + 1];
+
+		Strip.MinX = StripIndex == 0 ? -UE_DOUBLE_BIG_NUMBER : InPoints[SortedByX[Start]].X;
+		Strip.MaxX = End == NPoints ? UE_DOUBLE_BIG_NUMBER : InPoints[SortedByX[End]].X;
+		for (int32 i = Start; i < End; i++) {
+			Strip.Points.Add(InPoints[SortedByX[i]]);
+		}
+
+		FDTriangulation& Triangulation = Strip.Triangulation;
+		Triangulation.Reset(MinX, MinY, MaxX, MaxY, InDelaunayConvexMultiplier, Strip.Points.Num());
+		Triangulation.InsertPoints(Strip.Points);
 
-		for (int32 j = Edges.Num() - 2; j >= 0; j--)
-		{
-			for (int32 k = Edges.Num() - 1; k >= j + 1; k--)
-			{
-				if (Edges.IsValidIndex(j) && Edges.IsValidIndex(k) && Edges[j].IsSimilar(Edges[k]))
-				{
-					Edges.RemoveAt(j);
-					Edges.RemoveAt(k - 1);
+		// A triangle whose circumcircle stays inside the strip can't contain any other strip's points, so it is in the
+		// full triangulation. Every other triangle's points go to the seam.
+		TArray<bool> InSeam;
+		InSeam.Init(false, Triangulation.X.Num());
+		Strip.Final.Init(false, Triangulation.GetNumTriangleSlots());
+		for (int32 t = 0; t < Triangulation.GetNumTriangleSlots(); t++) {
+			if (!Triangulation.IsTriangleAlive(t)) continue;
+
+			const double CX = Triangulation.CircumX[t];
+			const double RadiusSqr = Triangulation.CircumRadiusSqr[t];
+			Strip.Final[t] = CX > Strip.MinX && CX < Strip.MaxX
+				&& FMath::Square(CX - Strip.MinX) > RadiusSqr
+				&& FMath::Square(Strip.MaxX - CX) > RadiusSqr;
+
+			bool bUsesSuperVertex = false;
+			for (int32 i = 0; i < 3; i++) {
+				const int32 Vertex = Triangulation.Triangles[t * 3 + i];
+				bUsesSuperVertex |= FDTriangulation::IsSuperVertex(Vertex);
+
+				if (!Strip.Final[t] && !FDTriangulation::IsSuperVertex(Vertex) && !InSeam[Vertex]) {
+					InSeam[Vertex] = true;
+					Strip.SeamPoints.Add(Strip.Points[Vertex - FDTriangulation::NumSuperVertices]);
 				}
 			}
+
+			if (Strip.Final[t] && !bUsesSuperVertex) {
+				Strip.Kept.Add(t);
+			}
+		}
+	});
+
+	// Merge: every triangle missing from the strips only uses seam points, so it is in the seam's triangulation. The
+	// seam triangulation covers the final triangles too, so skip any whose centroid lands on a final triangle.
+	FStrip Seam;
+	for (const FStrip& Strip : Strips) {
+		Seam.Points.Append(Strip.SeamPoints);
+	}
+	Seam.Triangulation.Reset(MinX, MinY, MaxX, MaxY, InDelaunayConvexMultiplier, Seam.Points.Num());
+	Seam.Triangulation.InsertPoints(Seam.Points);
+
+	TArray<int32> LocateHints;
+	LocateHints.Init(INDEX_NONE, Strips.Num());
+	for (int32 t = 0; t < Seam.Triangulation.GetNumTriangleSlots(); t++) {
+		if (!Seam.Triangulation.IsTriangleAlive(t)) continue;
+
+		const int32 V1 = Seam.Triangulation.Triangles[t * 3];
+		const int32 V2 = Seam.Triangulation.Triangles[t * 3 + 1];
+		const int32 V3 = Seam.Triangulation.Triangles[t * 3 + 2];
+		if (FDTriangulation::IsSuperVertex(V1) || FDTriangulation::IsSuperVertex(V2) || FDTriangulation::IsSuperVertex(V3)) continue;
+
+		const double CX = (Seam.Triangulation.X[V1] + Seam.Triangulation.X[V2] + Seam.Triangulation.X[V3]) / 3.0;
+		const double CY = (Seam.Triangulation.Y[V1] + Seam.Triangulation.Y[V2] + Seam.Triangulation.Y[V3]) / 3.0;
+
+		int32 StripIndex = 0;
+		while (StripIndex + 1 < Strips.Num() && CX >= Strips[StripIndex + 1].MinX) {
+			StripIndex++;
+		}
+
+		const FStrip& Strip = Strips[StripIndex];
+		const int32 Located = Strip.Triangulation.Locate(CX, CY, LocateHints[StripIndex]);
+		LocateHints[StripIndex] = Located;
+		if (Located == INDEX_NONE || !Strip.Final[Located]) {
+			Seam.Kept.Add(t);
+		}
+	}
+
+	// Copy the kept triangles into the mesh, strips first, then the seam. Twins inside a piece come straight from
+	// its half-edges, so only edges crossing between pieces need matching by vertex pair.
+	Strips.Add(MoveTemp(Seam));
+
+	TArray<int32> Offsets;
+	int32 NTriangles = 0;
+	for (const FStrip& Strip : Strips) {
+		Offsets.Add(NTriangles);
+		NTriangles += Strip.Kept.Num();
+	}
+
+	FDMesh Mesh;
+	Mesh.X.SetNumUninitialized(NPoints);
+	Mesh.Y.SetNumUninitialized(NPoints);
+	for (int32 i = 0; i < NPoints; i++) {
+		Mesh.X[i] = InPoints[i].X;
+		Mesh.Y[i] = InPoints[i].Y;
+	}
+	Mesh.Triangles.SetNumUninitialized(NTriangles * 3);
+	Mesh.HalfEdges.SetNumUninitialized(NTriangles * 3);
+
+	ParallelFor(Strips.Num(), [&](int32 StripIndex) {
+		const FStrip& Strip = Strips[StripIndex];
+		const FDTriangulation& Triangulation = Strip.Triangulation;
+
+		TArray<int32> Remap;
+		Remap.Init(INDEX_NONE, Triangulation.GetNumTriangleSlots());
+		for (int32 k = 0; k < Strip.Kept.Num(); k++) {
+			Remap[Strip.Kept[k]] = Offsets[StripIndex] + k;
 		}
 
-		for (int32 j = 0; j < Edges.Num(); j++) {
-			if (Triangles.Num() > TrMax) {
-				UE_LOG(LogActor, Error, TEXT("Made more triangles than required. "));
+		for (int32 k = 0; k < Strip.Kept.Num(); k++) {
+			for (int32 i = 0; i < 3; i++) {
+				const int32 E = (Offsets[StripIndex] + k) * 3 + i;
+				const int32 Twin = Triangulation.HalfEdges[Strip.Kept[k] * 3 + i];
+
+				Mesh.Triangles[E] = Strip.Points[Triangulation.Triangles[Strip.Kept[k] * 3 + i] - FDTriangulation::NumSuperVertices].Id;
+				Mesh.HalfEdges[E] = (Twin != INDEX_NONE && Remap[Twin / 3] != INDEX_NONE) ? Remap[Twin / 3] * 3 + Twin % 3 : INDEX_NONE;
 			}
+		}
+	});
+
+	TMap<uint64, int32> OpenEdges;
+	for (int32 E = 0; E < Mesh.HalfEdges.Num(); E++) {
+		if (Mesh.HalfEdges[E] != INDEX_NONE) continue;
 
-			Triangles.Add(FDTriangle(Edges[j].P1, Edges[j].P2, InPoints[i]));
+		const uint64 Start = (uint32)Mesh.GetEdgeStart(E);
+		const uint64 End = (uint32)Mesh.GetEdgeEnd(E);
+
+		int32 Twin;
+		if (OpenEdges.RemoveAndCopyValue((End << 32) | Start, Twin)) {
+			Mesh.HalfEdges[E] = Twin;
+			Mesh.HalfEdges[Twin] = E;
+		}
+		else {
+			OpenEdges.Add((Start << 32) | End, E);
 		}
 	}
 
-	// Remove triangles using the initial super points.
-	for (int i = Triangles.Num() - 1; i >= 0; i--) {
-		FDTriangle Triangle = Triangles[i];
-		if (Triangle.P1.Id >= NPoints
-			|| Triangle.P2.Id >= NPoints
-			|| Triangle.P3.Id >= NPoints
-			) {
-			Triangles.RemoveAt(i);
+	// Prefer hull edges so neighbour iteration can start from one end of the fan
+	Mesh.VertexHalfEdges.Init(INDEX_NONE, NPoints);
+	for (int32 E = 0; E < Mesh.Triangles.Num(); E++) {
+		const int32 Vertex = Mesh.Triangles[E];
+		if (Mesh.VertexHalfEdges[Vertex] == INDEX_NONE || Mesh.HalfEdges[E] == INDEX_NONE) {
+			Mesh.VertexHalfEdges[Vertex] = E;
 		}
 	}
-	// Remove the initial super points.
-	InPoints.Remove(SuP1);
-	InPoints.Remove(SuP2);
-	InPoints.Remove(SuP3);
 
-	return Triangles;
-}
\ No newline at end of file
+	return Mesh;
+}
+
+
+#if !UE_BUILD_SHIPPING
+
+// Times FindContainingCircles against the scalar path over the circumcircles of a real triangulation.
+// Usage: Ascent.Delaunay.BenchmarkInCircle [NumPoints] [NumQueries]
+static FAutoConsoleCommand BenchmarkInCircleCommand(
+	TEXT("Ascent.Delaunay.BenchmarkInCircle")
+	, TEXT("Compares the vectorized and scalar in-circle kernels.")
+	, FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+		const int32 NPoints = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000;
+		const int32 NQueries = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1000;
+
+		TArray<FDPoint> Points;
+		for (int32 i = 0; i < NPoints; i++) {
+			Points.Add(FDPoint(FMath::FRandRange(0.f, 1000.f), FMath::FRandRange(0.f, 1000.f), i));
+		}
+
+		FDTriangulation Triangulation;
+		Triangulation.Reset(0.0, 0.0, 1000.0, 1000.0, 1, NPoints);
+		Triangulation.InsertPoints(Points);
+
+		// Blocks of 64 to match how the triangulator calls the kernel
+		const int32 NCircles = Triangulation.GetNumTriangleSlots() / 64 * 64;
+		TArray<double> QueryX;
+		TArray<double> QueryY;
+		for (int32 i = 0; i < NQueries; i++) {
+			QueryX.Add(FMath::FRandRange(0.f, 1000.f));
+			QueryY.Add(FMath::FRandRange(0.f, 1000.f));
+		}
+
+		auto Run = [&](auto Kernel, uint64& OutChecksum) {
+			OutChecksum = 0;
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 q = 0; q < NQueries; q++) {
+				for (int32 Block = 0; Block < NCircles; Block += 64) {
+					OutChecksum += FMath::CountBits(Kernel(
+						&Triangulation.CircumX[Block]
+						, &Triangulation.CircumY[Block]
+						, &Triangulation.CircumRadiusSqr[Block]
+						, 64
+						, QueryX[q]
+						, QueryY[q]
+					));
+				}
+			}
+			return FPlatformTime::Seconds() - StartTime;
+		};
+
+		uint64 ScalarHits = 0;
+		uint64 VectorHits = 0;
+		const double ScalarTime = Run(&FDTriangulation::FindContainingCirclesScalar, ScalarHits);
+		const double VectorTime = Run(&FDTriangulation::FindContainingCircles, VectorHits);
+		const double NTests = (double)NCircles * NQueries;
+
+		UE_LOG(LogTemp, Display, TEXT("In-circle kernel, %d circles x %d queries"), NCircles, NQueries);
+		UE_LOG(LogTemp, Display, TEXT("  Scalar: %.3f ms (%.2f ns/test)"), ScalarTime * 1000.0, ScalarTime * 1e9 / NTests);
+		UE_LOG(LogTemp, Display, TEXT("  Vector: %.3f ms (%.2f ns/test), %.2fx"), VectorTime * 1000.0, VectorTime * 1e9 / NTests, ScalarTime / FMath::Max(VectorTime, 1e-9));
+		if (ScalarHits != VectorHits) {
+			UE_LOG(LogTemp, Error, TEXT("  Kernels disagree: %llu vs %llu hits"), ScalarHits, VectorHits);
+		}
+	})
+);
+
+// Times TriangulateMeshParallel with an increasing number of strips against the serial path, and checks that it
+// makes the same triangles. Usage: Ascent.Delaunay.BenchmarkParallel [NumPoints]
+static FAutoConsoleCommand BenchmarkParallelCommand(
+	TEXT("Ascent.Delaunay.BenchmarkParallel")
+	, TEXT("Measures how parallel triangulation scales with thread count.")
+	, FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+		const int32 NPoints = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100000;
+
+		TArray<FDPoint> Points;
+		for (int32 i = 0; i < NPoints; i++) {
+			Points.Add(FDPoint(FMath::FRandRange(0.f, 1000.f), FMath::FRandRange(0.f, 1000.f), i));
+		}
+
+		// Triangles rotated to start at their smallest index and packed 21 bits per index, so meshes compare as sorted lists
+		auto GetSortedTriangles = [](const FDMesh& Mesh) {
+			TArray<uint64> Sorted;
+			for (int32 t = 0; t < Mesh.GetNumTriangles(); t++) {
+				int32 First = t * 3;
+				for (int32 i = 1; i < 3; i++) {
+					if (Mesh.Triangles[t * 3 + i] < Mesh.Triangles[First]) {
+						First = t * 3 + i;
+					}
+				}
+				Sorted.Add(((uint64)Mesh.Triangles[First] << 42)
+					| ((uint64)Mesh.GetEdgeEnd(First) << 21)
+					| (uint64)Mesh.Triangles[FDMesh::PrevHalfEdge(First)]
+				);
+			}
+			Sorted.Sort();
+			return Sorted;
+		};
+
+		FDelaunay Delaunay;
+		double StartTime = FPlatformTime::Seconds();
+		const FDMesh SerialMesh = Delaunay.TriangulateMesh(Points, 1);
+		const double SerialTime = FPlatformTime::Seconds() - StartTime;
+		const TArray<uint64> SerialTriangles = GetSortedTriangles(SerialMesh);
+
+		UE_LOG(LogTemp, Display, TEXT("Delaunay, %d points, %d triangles"), NPoints, SerialMesh.GetNumTriangles());
+		UE_LOG(LogTemp, Display, TEXT("  Serial: %.3f ms"), SerialTime * 1000.0);
+
+		const int32 MaxStrips = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+		for (int32 NStrips = 2; NStrips < MaxStrips * 2; NStrips *= 2) {
+			StartTime = FPlatformTime::Seconds();
+			const FDMesh ParallelMesh = Delaunay.TriangulateMeshParallel(Points, 1, FMath::Min(NStrips, MaxStrips));
+			const double ParallelTime = FPlatformTime::Seconds() - StartTime;
+
+			UE_LOG(LogTemp, Display, TEXT("  %d strips: %.3f ms, %.2fx%s")
+				, FMath::Min(NStrips, MaxStrips)
+				, ParallelTime * 1000.0
+				, SerialTime / FMath::Max(ParallelTime, 1e-9)
+				, GetSortedTriangles(ParallelMesh) == SerialTriangles ? TEXT("") : TEXT(", TRIANGLES DIFFER")
+			);
+		}
+	})
+);
+
+#endif
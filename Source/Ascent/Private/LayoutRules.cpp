@@ -3,3 +3,116 @@
 
 #include "LayoutRules.h"
 
+void FRoomTypeDistribution::Build(FRoomTypeMask Domain, const float (&Weights)[NUM_ROOM_TYPES])
+{
+	Num = 0;
+	float Sum = 0;
+	for (int32 RoomType = 0; RoomType < NUM_ROOM_TYPES; RoomType++)
+	{
+		if ((Domain & ToRoomTypeMask((ERoomType)RoomType)) == 0) continue;
+
+		RoomTypes[Num++] = (ERoomType)RoomType;
+		Sum += Weights[RoomType];
+	}
+
+	// Scale the weights so the average slot holds exactly one, then split them into slots under and over that
+	float Scaled[NUM_ROOM_TYPES];
+	TArray<uint8, TInlineAllocator<NUM_ROOM_TYPES>> Small;
+	TArray<uint8, TInlineAllocator<NUM_ROOM_TYPES>> Large;
+	for (int32 i = 0; i < Num; i++)
+	{
+		Scaled[i] = Sum > 0 ? Weights[(uint8)RoomTypes[i]] * Num / Sum : 1.f;
+		Aliases[i] = i;
+		(Scaled[i] < 1.f ? Small : Large).Add(i);
+	}
+
+	// Top up each light slot from a heavy one, which becomes light itself once it falls under one
+	while (Small.Num() > 0 && Large.Num() > 0)
+	{
+		const uint8 Less = Small.Pop(false);
+		const uint8 More = Large.Pop(false);
+
+		Probabilities[Less] = Scaled[Less];
+		Aliases[Less] = More;
+
+		Scaled[More] = (Scaled[More] + Scaled[Less]) - 1.f;
+		(Scaled[More] < 1.f ? Small : Large).Add(More);
+	}
+
+	// Whatever is left is only off from one by rounding
+	for (uint8 Slot : Large)
+	{
+		Probabilities[Slot] = 1.f;
+	}
+	for (uint8 Slot : Small)
+	{
+		Probabilities[Slot] = 1.f;
+	}
+}
+
+FCompiledLayoutRules::FCompiledLayoutRules()
+	: FCompiledLayoutRules(FLayoutRules())
+{
+}
+
+FCompiledLayoutRules::FCompiledLayoutRules(const FLayoutRules& Rules)
+{
+	// Normalise weights
+	float WeightSum = 0;
+	for (const auto& RoomTypeWeight : Rules.RoomTypeWeights)
+	{
+		WeightSum += FMath::Max(RoomTypeWeight.Value, 0.f);
+	}
+
+	MaxRoomSize = FIntPoint::ZeroValue;
+	for (int32 RoomType = 0; RoomType < NUM_ROOM_TYPES; RoomType++)
+	{
+		const float* Weight = Rules.RoomTypeWeights.Find((ERoomType)RoomType);
+		Weights[RoomType] = Weight && WeightSum > 0 ? FMath::Max(*Weight, 0.f) / WeightSum : 0.f;
+
+		const F2DRange* RoomSize = Rules.RoomSizes.Find((ERoomType)RoomType);
+		RoomSizes[RoomType] = RoomSize ? *RoomSize : F2DRange();
+		MaxRoomSize.X = FMath::Max(MaxRoomSize.X, RoomSizes[RoomType].MaxX);
+		MaxRoomSize.Y = FMath::Max(MaxRoomSize.Y, RoomSizes[RoomType].MaxY);
+
+		RoomBPs[RoomType] = Rules.RoomBPs.FindRef((ERoomType)RoomType);
+	}
+
+	// A neighbour of a room of some type may only become the types whose rules list that type
+	FRoomTypeMask CompatibleWithRoomType[NUM_ROOM_TYPES] = {};
+	for (const auto& Rule : Rules.RoomEntropy)
+	{
+		for (ERoomType Possibility : Rule.Value.Possibilities)
+		{
+			CompatibleWithRoomType[(uint8)Possibility] |= ToRoomTypeMask(Rule.Key);
+		}
+	}
+
+	// A neighbour of a room that isn't collapsed yet may become anything compatible with one of the room's types
+	CompatibleRoomTypes[0] = 0;
+	for (int32 Domain = 1; Domain < (1 << NUM_ROOM_TYPES); Domain++)
+	{
+		CompatibleRoomTypes[Domain] = CompatibleRoomTypes[Domain & (Domain - 1)] | CompatibleWithRoomType[FMath::CountTrailingZeros((uint32)Domain)];
+	}
+
+	for (int32 Domain = 0; Domain < (1 << NUM_ROOM_TYPES); Domain++)
+	{
+		DomainDistributions[Domain].Build(Domain, Weights);
+
+		float Sum = 0;
+		float LogSum = 0;
+		for (int32 RoomType = 0; RoomType < NUM_ROOM_TYPES; RoomType++)
+		{
+			if ((Domain & ToRoomTypeMask((ERoomType)RoomType)) == 0) continue;
+
+			const float Weight = Weights[RoomType];
+			Sum += Weight;
+			if (Weight > 0)
+			{
+				LogSum += FMath::Log2(Weight) * Weight;
+			}
+		}
+
+		DomainEntropies[Domain] = Sum > 0 ? FMath::Log2(Sum) - (LogSum / Sum) : 0.f;
+	}
+}
@@ -3,3 +3,16 @@
 
 #include "LayoutRulesData.h"
 
+void ULayoutRulesData::PostLoad()
+{
+	Super::PostLoad();
+	CompiledRules = FCompiledLayoutRules(LayoutRules);
+}
+
+#if WITH_EDITOR
+void ULayoutRulesData::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	CompiledRules = FCompiledLayoutRules(LayoutRules);
+}
+#endif
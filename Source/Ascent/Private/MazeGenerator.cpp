@@ -4,16 +4,9 @@
 #include "Kismet/KismetSystemLibrary.h"
 #include "Math/UnrealMathUtility.h"
 #include "Algo/Reverse.h"
-
-bool operator==(const FPathCell A, const FPathCell* B)
-{
-	return A.GridPos == B->GridPos;
-}
-
-bool operator==(const FPathCell A, const FPathCell& B)
-{
-	return A.GridPos == B.GridPos;
-}
+#include "Tasks/Task.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/IConsoleManager.h"
 
 #pragma region Pathfinding Helpers
 
@@ -26,34 +19,18 @@ double Distance(FIntPoint A, FIntPoint B)
 	//return FMath::Sqrt((double)FMath::Square(B.X - A.X) + FMath::Square(B.Y - A.Y));
 }
 
-TArray<FIntPoint> ConstructPath(FPathCell& End)
+TArray<FIntPoint> ConstructPath(const Grid& PathGrid, const FPathSearchState& Search, int32 End)
 {
 	TArray<FIntPoint> Points;
-	FPathCell* SearchNode = &End;
-	
-	while (SearchNode)
+	for (int32 Cell = End; Cell != INDEX_NONE; Cell = Search.Parents[Cell])
 	{
-		if (Points.Contains(SearchNode->GridPos))
+		// A path can't visit more cells than the grid has unless the parents loop
+		if (Points.Num() >= PathGrid.Num())
 		{
 			UE_LOG(LogTemp, Error, TEXT("Path contains duplicate points. Aborting."));
 			break;
 		}
-		Points.Add(SearchNode->GridPos);
-
-		if (SearchNode->Parent != nullptr)
-		{
-			//FIntPoint StartPos = SearchNode->GridPos;
-			//FIntPoint Dist = Distance(SearchNode->Parent->GridPos, SearchNode->GridPos);
-			//int32 MaxDimension = FMath::Max(FMath::Abs(Dist.X), FMath::Abs(Dist.Y));
-			//Dist.X = FMath::Clamp(Dist.X, -1, 1);
-			//Dist.Y = FMath::Clamp(Dist.Y, -1, 1);
-			//for (int x = 0; x < MaxDimension - 1; x++)
-			//{
-			//	Points.Add(StartPos += Dist);
-			//}
-		}
-
-		SearchNode = SearchNode->Parent;
+		Points.Add(PathGrid.GetGridPos(Cell));
 	}
 	Algo::Reverse(Points);
 	return Points;
@@ -64,85 +41,280 @@ bool IsValidPoint(FIntPoint A, const Grid& PathGrid)
 	return A.X >= 0 && A.X < PathGrid.GetLength(0) && A.Y >= 0 && A.Y < PathGrid.GetLength(1);
 }
 
-FPathCell* GetNeighbour(FIntPoint A, FIntPoint Direction, int32 Distance, const Grid& PathGrid)
+int32 GetNeighbour(FIntPoint A, FIntPoint Direction, int32 Distance, const Grid& PathGrid)
 {
 	FIntPoint Vec = A + (Direction * Distance);
-	if (IsValidPoint(Vec, PathGrid)) return &PathGrid[Vec.X][Vec.Y];
-	return nullptr;
+	if (IsValidPoint(Vec, PathGrid)) return PathGrid.GetIndex(Vec);
+	return INDEX_NONE;
 }
 
-int32 DistanceToWall(FPathCell& End, FIntPoint Direction, const Grid& PathGrid)
+bool IsDiagonal(FIntPoint Direction)
 {
-	int32 Distance = 0;
-	FPathCell* SearchNode = &End;
-	while (SearchNode)
+	return Direction.X != 0 && Direction.Y != 0;
+}
+
+// Octile distance, the exact cost of the shortest path between two cells on open ground
+int32 OctileDistance(FIntPoint A, FIntPoint B)
+{
+	const int32 X = FMath::Abs(B.X - A.X);
+	const int32 Y = FMath::Abs(B.Y - A.Y);
+	return FMath::Min(X, Y) * FPathSearchState::DIAGONAL_COST + FMath::Abs(X - Y) * FPathSearchState::STRAIGHT_COST;
+}
+
+// The eight directions a path can step in, going round from +X. Even ones are straight and odd ones diagonal, and
+// a diagonal's straight parts are the directions either side of it.
+static const FIntPoint PathDirections[FJumpDistances::NUM_DIRECTIONS] = { FIntPoint(1,0), FIntPoint(1,1), FIntPoint(0, 1), FIntPoint(-1, 1), FIntPoint(-1, 0), FIntPoint(-1,-1), FIntPoint(0, -1), FIntPoint(1, -1) };
+
+int32 GetDirectionIndex(FIntPoint Direction)
+{
+	static const int32 Indices[] = { 5, 6, 7, 4, INDEX_NONE, 0, 3, 2, 1 };
+	return Indices[(Direction.Y + 1) * 3 + Direction.X + 1];
+}
+
+// Calls Visit with the index of each walkable neighbour of a cell and the cost of stepping to it
+template <typename VisitorType>
+void ForEachNeighbour(FIntPoint GridPos, const Grid& PathGrid, VisitorType&& Visit)
+{
+	for (const FIntPoint& Direction : PathDirections)
 	{
-		SearchNode = GetNeighbour(SearchNode->GridPos, Direction, 1, PathGrid);
-		if (SearchNode == nullptr || !SearchNode->IsWalkable) break;
-		Distance++;
+		const int32 Neighbour = GetNeighbour(GridPos, Direction, 1, PathGrid);
+		if (Neighbour != INDEX_NONE && PathGrid.IsWalkable(Neighbour))
+		{
+			Visit(Neighbour, IsDiagonal(Direction) ? FPathSearchState::DIAGONAL_COST : FPathSearchState::STRAIGHT_COST);
+		}
 	}
-	return Distance;
 }
 
-bool IsInExactDirection(FIntPoint A, FIntPoint B, FIntPoint Direction)
+bool IsWalkablePoint(FIntPoint A, const Grid& PathGrid)
 {
-	int32 X = FMath::Clamp(B.X - A.X, -1, 1);
-	int32 Y = FMath::Clamp(B.Y - A.Y, -1, 1);
-	return Direction == FIntPoint(X, Y);
+	return IsValidPoint(A, PathGrid) && PathGrid.IsWalkable(PathGrid.GetIndex(A));
 }
 
-bool IsCardinal(FIntPoint Direction)
+// Whether a cell stepped onto in a direction is a jump point, i.e. a path through it may need to turn there. A wall
+// beside a straight step, or behind a diagonal one, opens a neighbour that only a turn at the cell reaches.
+template <typename IsWalkableType>
+bool HasForcedNeighbour(FIntPoint GridPos, FIntPoint Direction, IsWalkableType&& IsWalkable)
 {
-	bool Vertical = Direction.X == 1;
-	bool Horizontal = Direction.Y == 1;
-	return Vertical ^ Horizontal;
+	const int32 X = GridPos.X;
+	const int32 Y = GridPos.Y;
+	const int32 DX = Direction.X;
+	const int32 DY = Direction.Y;
+	if (DX != 0 && DY != 0)
+	{
+		return (!IsWalkable(FIntPoint(X - DX, Y)) && IsWalkable(FIntPoint(X - DX, Y + DY))) ||
+			(!IsWalkable(FIntPoint(X, Y - DY)) && IsWalkable(FIntPoint(X + DX, Y - DY)));
+	}
+
+	// The two sides of a straight step
+	const FIntPoint Side(DY, DX);
+	return (!IsWalkable(GridPos + Side) && IsWalkable(GridPos + Side + Direction)) ||
+		(!IsWalkable(GridPos - Side) && IsWalkable(GridPos - Side + Direction));
 }
 
-bool IsDiagonal(FIntPoint Direction)
+void BuildJumpDistances(const Grid& PathGrid, FJumpDistances& JumpDistances)
 {
-	return Direction.X != 0 && Direction.Y != 0;
+	const int32 Length = PathGrid.GetLength(0);
+	const int32 Width = PathGrid.GetLength(1);
+	JumpDistances.Distances.SetNumUninitialized(PathGrid.Num() * FJumpDistances::NUM_DIRECTIONS);
+
+	// Walkability row by row with two cells of wall all round, which is as far as the checks below look past a cell,
+	// so they need neither bounds checks nor the grid's cell order
+	const int32 PADDING = 2;
+	const int32 PaddedWidth = Width + PADDING * 2;
+	TArray<bool> Walkable;
+	Walkable.Init(false, (Length + PADDING * 2) * PaddedWidth);
+	for (int32 X = 0; X < Length; X++)
+	{
+		for (int32 Y = 0; Y < Width; Y++)
+		{
+			Walkable[(X + PADDING) * PaddedWidth + Y + PADDING] = PathGrid.IsWalkable(PathGrid.GetIndex(FIntPoint(X, Y)));
+		}
+	}
+	const auto IsWalkable = [&Walkable, PaddedWidth, PADDING](FIntPoint GridPos) {
+		return Walkable[(GridPos.X + PADDING) * PaddedWidth + GridPos.Y + PADDING];
+	};
+
+	// Each cell's distance builds on the next cell's in the same direction, so cells are visited walking against the
+	// direction. Diagonal jump points depend on straight distances, so all straight directions go first.
+	const int32 DirectionOrder[] = { 0, 2, 4, 6, 1, 3, 5, 7 };
+	for (const int32 Direction : DirectionOrder)
+	{
+		const FIntPoint Step = PathDirections[Direction];
+		const bool bDiagonal = IsDiagonal(Step);
+		const int32 StraightX = Direction - 1;
+		const int32 StraightY = (Direction + 1) % FJumpDistances::NUM_DIRECTIONS;
+
+		for (int32 i = 0; i < Length; i++)
+		{
+			const int32 X = Step.X > 0 ? Length - 1 - i : i;
+			for (int32 j = 0; j < Width; j++)
+			{
+				const int32 Y = Step.Y > 0 ? Width - 1 - j : j;
+				const FIntPoint Next = FIntPoint(X, Y) + Step;
+
+				int32 Distance = 0;
+				if (IsWalkable(Next))
+				{
+					const int32 NextCell = PathGrid.GetIndex(Next);
+					const bool bJumpPoint = HasForcedNeighbour(Next, Step, IsWalkable) ||
+						(bDiagonal && (JumpDistances.Get(NextCell, StraightX) > 0 || JumpDistances.Get(NextCell, StraightY) > 0));
+
+					const int32 NextDistance = JumpDistances.Get(NextCell, Direction);
+					Distance = bJumpPoint ? 1 : NextDistance > 0 ? NextDistance + 1 : NextDistance - 1;
+				}
+				JumpDistances.Distances[PathGrid.GetIndex(FIntPoint(X, Y)) * FJumpDistances::NUM_DIRECTIONS + Direction] = Distance;
+			}
+		}
+	}
 }
 
-FIntPoint GetGeneralDirection(FIntPoint A, FIntPoint B)
+// Calls Visit with each jump point reachable from a cell and the cost of getting there. Only the directions a path
+// through the cell's parent could still need are followed: onward, plus around any wall beside the cell. The goal
+// stands in for a jump point whenever a direction passes it, or passes level with it when moving diagonally.
+template <typename VisitorType>
+void ForEachJumpPoint(int32 Cell, FIntPoint Goal, const Grid& PathGrid, const FPathSearchState& Search, const FJumpDistances& JumpDistances, VisitorType&& Visit)
 {
-	TArray<FIntPoint> Directions = { FIntPoint(1,0), FIntPoint(1,1), FIntPoint(0, 1), FIntPoint(-1, 1), FIntPoint(-1, 0), FIntPoint(-1,-1), FIntPoint(0, -1), FIntPoint(1, -1) };
+	const FIntPoint GridPos = PathGrid.GetGridPos(Cell);
+	const int32 X = GridPos.X;
+	const int32 Y = GridPos.Y;
+
+	TArray<int32, TInlineAllocator<FJumpDistances::NUM_DIRECTIONS>> Directions;
+	const int32 Parent = Search.Parents[Cell];
+	if (Parent == INDEX_NONE)
+	{
+		for (int32 Direction = 0; Direction < FJumpDistances::NUM_DIRECTIONS; Direction++)
+		{
+			Directions.Add(Direction);
+		}
+	}
+	else
+	{
+		const FIntPoint ParentPos = PathGrid.GetGridPos(Parent);
+		const int32 DX = FMath::Sign(X - ParentPos.X);
+		const int32 DY = FMath::Sign(Y - ParentPos.Y);
+		if (DX != 0 && DY != 0)
+		{
+			Directions.Add(GetDirectionIndex(FIntPoint(DX, 0)));
+			Directions.Add(GetDirectionIndex(FIntPoint(0, DY)));
+			Directions.Add(GetDirectionIndex(FIntPoint(DX, DY)));
+			if (!IsWalkablePoint(FIntPoint(X - DX, Y), PathGrid)) Directions.Add(GetDirectionIndex(FIntPoint(-DX, DY)));
+			if (!IsWalkablePoint(FIntPoint(X, Y - DY), PathGrid)) Directions.Add(GetDirectionIndex(FIntPoint(DX, -DY)));
+		}
+		else
+		{
+			const FIntPoint Step(DX, DY);
+			const FIntPoint Side(DY, DX);
+			Directions.Add(GetDirectionIndex(Step));
+			if (!IsWalkablePoint(GridPos + Side, PathGrid)) Directions.Add(GetDirectionIndex(Step + Side));
+			if (!IsWalkablePoint(GridPos - Side, PathGrid)) Directions.Add(GetDirectionIndex(Step - Side));
+		}
+	}
+
+	const FIntPoint ToGoal = Goal - GridPos;
+	for (const int32 Direction : Directions)
+	{
+		const FIntPoint Step = PathDirections[Direction];
+		const int32 Distance = JumpDistances.Get(Cell, Direction);
+		const int32 Reach = FMath::Abs(Distance);
 
-	FVector2D Vec = B - A;
-	float Angle = FMath::Atan2(Vec.Y, Vec.X);
-	int32 Octant = FMath::RoundToInt(8 * Angle / (2 * PI) + 8) % 8;
-	return Directions[Octant];
+		// How many steps in this direction until the goal is straight ahead or level with us, if it ever is
+		int32 StepsToGoal = INDEX_NONE;
+		if (IsDiagonal(Step))
+		{
+			if (FMath::Sign(ToGoal.X) == Step.X && FMath::Sign(ToGoal.Y) == Step.Y)
+			{
+				StepsToGoal = FMath::Min(FMath::Abs(ToGoal.X), FMath::Abs(ToGoal.Y));
+			}
+		}
+		else if (ToGoal.X * Step.Y == ToGoal.Y * Step.X && ToGoal.X * Step.X + ToGoal.Y * Step.Y > 0)
+		{
+			StepsToGoal = FMath::Abs(ToGoal.X + ToGoal.Y);
+		}
+
+		int32 Steps = 0;
+		if (StepsToGoal != INDEX_NONE && StepsToGoal <= Reach)
+		{
+			Steps = StepsToGoal;
+		}
+		else if (Distance > 0)
+		{
+			Steps = Distance;
+		}
+		else
+		{
+			continue;
+		}
+
+		const FIntPoint JumpPoint = GridPos + Step * Steps;
+		Visit(PathGrid.GetIndex(JumpPoint), OctileDistance(GridPos, JumpPoint));
+	}
 }
 
-FPathCell* GetLowestCostCell(TArray<FPathCell*>& OpenList)
+// Fills in the cells between consecutive jump points, which always share a row, column or diagonal
+TArray<FIntPoint> ExpandJumpPoints(const TArray<FIntPoint>& JumpPoints)
 {
-	FPathCell* CurMin = nullptr;
-	for (FPathCell* Cell : OpenList)
+	TArray<FIntPoint> Points;
+	for (int32 i = 0; i < JumpPoints.Num(); i++)
 	{
-		if (CurMin == nullptr || Cell->fCost() < CurMin->fCost())
+		if (i > 0)
 		{
-			CurMin = Cell;
+			const FIntPoint Step(FMath::Sign(JumpPoints[i].X - JumpPoints[i - 1].X), FMath::Sign(JumpPoints[i].Y - JumpPoints[i - 1].Y));
+			for (FIntPoint Point = JumpPoints[i - 1] + Step; Point != JumpPoints[i]; Point += Step)
+			{
+				Points.Add(Point);
+			}
 		}
+		Points.Add(JumpPoints[i]);
 	}
-	return CurMin;
+	return Points;
 }
 
-TArray<FPathCell*> GetNeighbours(FPathCell& Current, const Grid& PathGrid)
+// A* from one cell to another, expanding each cell into whatever ForEachSuccessor calls its visitor with. Returns
+// the cells along the best path, or nothing if there isn't one.
+template <typename SuccessorsType>
+TArray<FIntPoint> FindPath(const Grid& PathGrid, FPathSearchState& Search, FIntPoint StartPoint, FIntPoint EndPoint, SuccessorsType&& ForEachSuccessor)
 {
-	TArray<FPathCell*> Neighbours;
-	for (int X = -1; X <= 1; X++)
+	const int32 StartNode = PathGrid.GetIndex(StartPoint);
+	const int32 EndNode = PathGrid.GetIndex(EndPoint);
+
+	Search.BeginSearch();
+	Search.Reach(StartNode);
+	Search.GCosts[StartNode] = 0;
+
+	FPathOpenList OpenList(Search);
+	OpenList.Push(StartNode, OctileDistance(StartPoint, EndPoint));
+
+	for (int32 CurNode = OpenList.Pop(); CurNode != INDEX_NONE; CurNode = OpenList.Pop())
 	{
-		for (int Y = -1; Y <= 1; Y++)
+		if (CurNode == EndNode)
 		{
-			if (X == 0 && Y == 0) continue;
-			FIntPoint Vec = FIntPoint(X, Y);
-			FPathCell* Neighbour = GetNeighbour(Current.GridPos, Vec, 1, PathGrid);
-			if (Neighbour != nullptr && Neighbour->IsWalkable)
+			return ConstructPath(PathGrid, Search, EndNode);
+		}
+
+		Search.Closed[CurNode] = true;
+
+		const int32 CurGCost = Search.GCosts[CurNode];
+		ForEachSuccessor(CurNode, [&](int32 Node, int32 StepCost) {
+			if (Search.IsClosed(Node)) return;
+
+			const int32 TentativeGScore = CurGCost + StepCost;
+			if (TentativeGScore >= Search.GetGCost(Node)) return;
+
+			Search.Reach(Node);
+			Search.Parents[Node] = CurNode;
+			Search.GCosts[Node] = TentativeGScore;
+			if (OpenList.Contains(Node))
 			{
-				Neighbours.Add(Neighbour);
+				OpenList.DecreaseKey(Node);
 			}
-		}
+			else
+			{
+				OpenList.Push(Node, OctileDistance(EndPoint, PathGrid.GetGridPos(Node)));
+			}
+		});
 	}
-	return Neighbours;
+
+	return TArray<FIntPoint>();
 }
 
 FIntPoint GetClosestRoomEdge(const FRoomData& RoomA, const FRoomData& RoomB)
@@ -169,6 +341,14 @@ AMazeGenerator::AMazeGenerator()
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
+
+	MaxRoomTypingBacktracks = 1000;
+	ParallelRoomTypingAttempts = 1;
+	ParallelCorridorSearches = 0;
+	bParallelTriangulation = false;
+	RoomSizingMode = ERoomSizingMode::PushApart;
+	bTilePathGrid = false;
+	CorridorSearchMode = ECorridorSearchMode::AStar;
 }
 
 // Called when the game starts or when spawned
@@ -187,16 +367,26 @@ void AMazeGenerator::Tick(float DeltaTime)
 void AMazeGenerator::GenerateMap()
 {
 	TArray<FDPoint> Points;
-	TMap<FDPoint, TArray<FDPoint>> Adjacencies;
-	PlacePoints(Points);
-	TriangulateLinks(Points, Adjacencies);
+	FRoomGraph RoomGraph;
+	CompileLayoutRules();
+	if (PlacePoints(Points) < 3)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Not enough rooms placed to build a layout."));
+		return;
+	}
+	if (!TriangulateLinks(Points, RoomGraph)) return;
 
-	DetermineRoomTypes(Adjacencies, CachedRoomDataCollection);
+	DetermineRoomTypes(Points, RoomGraph, CachedRoomDataCollection);
 
-	BuildLinks(CachedRoomDataCollection);
+	BuildLinks(CachedRoomDataCollection, RoomGraph);
 }
 
-void AMazeGenerator::PlacePoints(TArray<FDPoint>& Points)
+void AMazeGenerator::CompileLayoutRules()
+{
+	CompiledLayoutRules = LayoutRulesData ? LayoutRulesData->GetCompiledRules() : FCompiledLayoutRules(LayoutRules);
+}
+
+int32 AMazeGenerator::PlacePoints(TArray<FDPoint>& Points)
 {
 	if (bDebug)
 	{
@@ -211,239 +401,276 @@ void AMazeGenerator::PlacePoints(TArray<FDPoint>& Points)
 	
 	}
 
-	TArray<F2DRange> RoomSizes;
-	LayoutRules.RoomSizes.GenerateValueArray(RoomSizes);
-	RoomSizes.Sort([](const F2DRange& A, const F2DRange& B) { return A.MaxX < B.MaxX; });
-	const uint8 MAX_BUFFER_X = RoomSizes.Last().MaxX * 4;
-	RoomSizes.Sort([](const F2DRange& A, const F2DRange& B) { return A.MaxY < B.MaxY; });
-	const uint8 MAX_BUFFER_Y = RoomSizes.Last().MaxY * 4;
+	// Spacing is worked out from the largest room, which there is none of without room sizes
+	if (CompiledLayoutRules.MaxRoomSize.X <= 0 || CompiledLayoutRules.MaxRoomSize.Y <= 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Layout rules have no room sizes to space rooms by."));
+		return 0;
+	}
+
+	const int32 MAX_BUFFER_X = CompiledLayoutRules.MaxRoomSize.X * 4;
+	const int32 MAX_BUFFER_Y = CompiledLayoutRules.MaxRoomSize.Y * 4;
 
-	for (int32 i = 0; i < TargetDensity; i++)
+	Points.Reset();
+
+	const int32 MinX = MAX_BUFFER_X;
+	const int32 MaxX = Length - MAX_BUFFER_X;
+	const int32 MinY = MAX_BUFFER_Y;
+	const int32 MaxY = Width - MAX_BUFFER_Y;
+	if (MaxX < MinX || MaxY < MinY)
 	{
-		while (true)
-		{
-			uint8 X = FMath::RandRange(MAX_BUFFER_X, Length - MAX_BUFFER_X);
-			uint8 Y = FMath::RandRange(MAX_BUFFER_Y, Width - MAX_BUFFER_Y);
-			FDPoint Point = FDPoint(X, Y, i);
+		UE_LOG(LogTemp, Error, TEXT("Grid is too small to fit any rooms."));
+		return 0;
+	}
 
-			bool bIsTooClose = false;
-			for (FDPoint& PointB : Points)
+	// Bridson's Poisson-disk sampling. Points are never closer than the largest buffer, and the background
+	// grid's cells are sized so each one can hold at most one point, so a candidate only checks a 5x5 block.
+	// Sampling stops at the target room count, so points are also spread to about the area's share per room, which
+	// fills the area with a few more than the target. Otherwise they would clump around the first point.
+	const float SpreadDistance = FMath::Sqrt((float)(MaxX - MinX) * (MaxY - MinY) / (2.f * FMath::Max<int32>(TargetDensity, 1)));
+	const float MinDistance = FMath::Max3((float)MAX_BUFFER_X, (float)MAX_BUFFER_Y, SpreadDistance);
+	const float CellExtent = MinDistance / UE_SQRT_2;
+	const int32 MAX_CANDIDATES = 30;
+	const int32 GridX = FMath::FloorToInt((MaxX - MinX) / CellExtent) + 1;
+	const int32 GridY = FMath::FloorToInt((MaxY - MinY) / CellExtent) + 1;
+
+	TArray<int32> BackgroundGrid;
+	BackgroundGrid.Init(INDEX_NONE, GridX * GridY);
+	TArray<int32> ActiveList;
+
+	auto GetCell = [&](int32 X, int32 Y) {
+		return FIntPoint(FMath::FloorToInt((X - MinX) / CellExtent), FMath::FloorToInt((Y - MinY) / CellExtent));
+	};
+
+	auto IsFarEnough = [&](int32 X, int32 Y) {
+		const FIntPoint Cell = GetCell(X, Y);
+		for (int32 CellY = FMath::Max(Cell.Y - 2, 0); CellY <= FMath::Min(Cell.Y + 2, GridY - 1); CellY++)
+		{
+			for (int32 CellX = FMath::Max(Cell.X - 2, 0); CellX <= FMath::Min(Cell.X + 2, GridX - 1); CellX++)
 			{
-				float Dist = Point.GetDist(FVector2D(PointB.X, PointB.Y));
-				if (Dist < MAX_BUFFER_X || Dist < MAX_BUFFER_Y)
+				const int32 PointIndex = BackgroundGrid[CellY * GridX + CellX];
+				if (PointIndex != INDEX_NONE && Points[PointIndex].GetDistSqr(FVector2D(X, Y)) < FMath::Square(MinDistance))
 				{
-					bIsTooClose = true;
+					return false;
 				}
 			}
-
-			if (bIsTooClose) continue;
-			Points.Add(Point);
-			break;
 		}
-	}
-}
+		return true;
+	};
 
-void AMazeGenerator::TriangulateLinks(TArray<FDPoint>& Points, OUT TMap<FDPoint, TArray<FDPoint>>& RoomAdjacencies)
-{
-	FDelaunay Delauney;
-	const TArray<FDTriangle> Triangles = Delauney.Triangulate(Points, 1);
+	auto AddPoint = [&](int32 X, int32 Y) {
+		const FIntPoint Cell = GetCell(X, Y);
+		BackgroundGrid[Cell.Y * GridX + Cell.X] = Points.Num();
+		ActiveList.Add(Points.Num());
+		Points.Add(FDPoint(X, Y, Points.Num()));
+	};
 
-	//Prepare to calcule MST by mapping all adjacencies
-	TMap<FDPoint, TArray<FDEdge>> RawAdjacencies;
-	for (const FDTriangle& Triangle : Triangles)
+	AddPoint(FMath::RandRange(MinX, MaxX), FMath::RandRange(MinY, MaxY));
+
+	while (ActiveList.Num() > 0 && Points.Num() < TargetDensity)
 	{
-		for (int32 i = 0; i < 3; i++)
-		{
-			const FDEdge Edge = (
-				i == 0 ? Triangle.E1
-				: i == 1 ? Triangle.E2
-				: i == 2 ? Triangle.E3
-				// Invalid
-				: FDEdge(FDPoint(0.f, 0.f, -1), FDPoint(0.f, 0.f, -1))
-				);
+		const int32 ActiveIndex = FMath::RandRange(0, ActiveList.Num() - 1);
+		const FDPoint Origin = Points[ActiveList[ActiveIndex]];
 
-			// Initiate adjacency matrix to save if checks later
-			if (!RawAdjacencies.Contains(Edge.P1))
-			{
-				RawAdjacencies.Add(Edge.P1);
-				RoomAdjacencies.Add(Edge.P1);
-			}
+		bool bPlaced = false;
+		for (int32 Candidate = 0; Candidate < MAX_CANDIDATES; Candidate++)
+		{
+			// Sample uniformly from the annulus between one and two times the minimum distance
+			const float Angle = FMath::FRandRange(0.f, 2.f * PI);
+			const float Radius = MinDistance * FMath::Sqrt(FMath::FRandRange(1.f, 4.f));
+			const int32 X = FMath::RoundToInt(Origin.X + Radius * FMath::Cos(Angle));
+			const int32 Y = FMath::RoundToInt(Origin.Y + Radius * FMath::Sin(Angle));
 
-			if (!RawAdjacencies.Contains(Edge.P2))
-			{
-				RawAdjacencies.Add(Edge.P2);
-				RoomAdjacencies.Add(Edge.P2);
-			}
+			if (X < MinX || X > MaxX || Y < MinY || Y > MaxY || !IsFarEnough(X, Y)) continue;
 
-			RawAdjacencies[Edge.P1].AddUnique(Edge);
-			RawAdjacencies[Edge.P2].AddUnique(FDEdge::GetInverted(Edge));
+			AddPoint(X, Y);
+			bPlaced = true;
+			break;
+		}
 
-			if (bDebug)
-			{
-				//UKismetSystemLibrary::DrawDebugLine(
-				//	this
-				//	, FVector(Edge.P1.X * CellSize, Edge.P1.Y * CellSize, 0.f)
-				//	, FVector(Edge.P2.X * CellSize, Edge.P2.Y * CellSize, 0.f)
-				//	, FColor::Red
-				//	, 500.f
-				//	, 8.f
-				//);
-			}
+		if (!bPlaced)
+		{
+			ActiveList.RemoveAtSwap(ActiveIndex);
 		}
 	}
 
-	//Prim's algorithm to determine MST
-
-	TArray<bool> Visited;
-	Visited.Init(false, RawAdjacencies.Num());
-	TArray<FDEdge> EdgeQueue;
+	if (Points.Num() < TargetDensity)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Only placed %d of %d rooms. The grid is too small for the target density."), Points.Num(), TargetDensity);
+	}
 
-	EdgeQueue.HeapPush(FDEdge(Triangles[0].E1));
+	return Points.Num();
+}
 
-	while (EdgeQueue.Num() != 0)
+bool AMazeGenerator::TriangulateLinks(TArray<FDPoint>& Points, OUT FRoomGraph& RoomGraph)
+{
+	FDelaunay Delauney;
+	const FDMesh Mesh = bParallelTriangulation ? Delauney.TriangulateMeshParallel(Points, 1) : Delauney.TriangulateMesh(Points, 1);
+	if (Mesh.GetNumTriangles() == 0)
 	{
-		FDEdge Edge;
-		EdgeQueue.HeapPop(Edge, FDEdgeMinComparitor());
-
-		FDPoint Point = Edge.P1;
+		UE_LOG(LogTemp, Error, TEXT("Triangulation produced no triangles."));
+		return false;
+	}
 
-		if (Visited[Point.Id]) continue;
-		Visited[Point.Id] = true;
+	// Gather the unique edges once, keyed by squared length with the edge index in the low bits. Lengths are
+	// non-negative, so their float bits sort in the same order as the lengths themselves.
+	TArray<FIntPoint> Edges;
+	TArray<uint64> SortedEdges;
+	Edges.Reserve(Mesh.GetNumTriangles() * 3 / 2 + 1);
+	SortedEdges.Reserve(Mesh.GetNumTriangles() * 3 / 2 + 1);
+	Mesh.ForEachEdge([&](int32 E)
+	{
+		const int32 EdgeIndex = Edges.Add(FIntPoint(Mesh.GetEdgeStart(E), Mesh.GetEdgeEnd(E)));
+		SortedEdges.Add(((uint64)FMath::AsUInt(Mesh.GetEdgeLengthSqr(E)) << 32) | (uint32)EdgeIndex);
 
-		if (!Corridors.Contains(Edge))
+		if (bDebug)
 		{
-			RoomAdjacencies[Edge.P1].AddUnique(Edge.P2);
-			RoomAdjacencies[Edge.P2].AddUnique(Edge.P1);
-			Corridors.Add(Edge);
+			//UKismetSystemLibrary::DrawDebugLine(
+			//	this
+			//	, FVector(Points[Edges.Last().X].X * CellSize, Points[Edges.Last().X].Y * CellSize, 0.f)
+			//	, FVector(Points[Edges.Last().Y].X * CellSize, Points[Edges.Last().Y].Y * CellSize, 0.f)
+			//	, FColor::Red
+			//	, 500.f
+			//	, 8.f
+			//);
 		}
+	});
+	SortedEdges.Sort();
 
-		for (FDEdge& AdjacentEdge : RawAdjacencies[Point])
+	//Kruskal's algorithm to determine MST, with a path-halving union-find over point indices
+
+	TArray<int32> Parents;
+	Parents.SetNumUninitialized(Points.Num());
+	for (int32 i = 0; i < Points.Num(); i++)
+	{
+		Parents[i] = i;
+	}
+
+	auto FindRoot = [&Parents](int32 Point)
+	{
+		while (Parents[Point] != Point)
 		{
-			if (Visited[AdjacentEdge.P2.Id]) continue;
+			Parents[Point] = Parents[Parents[Point]];
+			Point = Parents[Point];
+		}
+		return Point;
+	};
 
-			EdgeQueue.HeapPush(FDEdge::GetInverted(AdjacentEdge), FDEdgeMinComparitor());
+	// Pairs of point indices
+	TArray<FIntPoint> Corridors;
+	Corridors.Reserve(Edges.Num());
+	for (const uint64 SortedEdge : SortedEdges)
+	{
+		const FIntPoint& Edge = Edges[(uint32)SortedEdge];
+		const int32 RootA = FindRoot(Edge.X);
+		const int32 RootB = FindRoot(Edge.Y);
 
-			if ((FMath::RandRange(0, 1) - AdditionalCorridorChance) > 0 && !Corridors.Contains(AdjacentEdge))
-			{
-				// Chance to create an additional link that isn't in the MST
-				RoomAdjacencies[AdjacentEdge.P1].AddUnique(AdjacentEdge.P2);
-				RoomAdjacencies[AdjacentEdge.P2].AddUnique(AdjacentEdge.P1);
-				Corridors.Add(AdjacentEdge);
-			}
+		if (RootA != RootB)
+		{
+			Parents[RootA] = RootB;
+		}
+		else if (FMath::FRand() >= AdditionalCorridorChance)
+		{
+			continue;
 		}
+
+		// Either an MST edge, or a chance to create an additional link that isn't in the MST
+		Corridors.Add(Edge);
 	}
+
+	RoomGraph.Build(Points.Num(), Corridors);
+	return true;
 }
 
 #pragma region Room Typing
 
-void AMazeGenerator::DetermineRoomTypes(const TMap<FDPoint, TArray<FDPoint>>& RoomAdjacency, OUT TArray<FRoomData>& RoomDataCollection)
+void AMazeGenerator::DetermineRoomTypes(const TArray<FDPoint>& Points, FRoomGraph& RoomGraph, OUT TArray<FRoomData>& RoomDataCollection)
 {
 	// Use wave function collapse to determine room types
 
-	TArray<FRoomTile> RoomTiles;
-
+	FRoomTypingState State;
+	State.Tiles.Init(FRoomTile(), Points.Num());
+	State.EntropyQueue.Reset(Points.Num());
 
-	uint8 CollapsedRooms = 0;
-	bool bMandatoryRoomsPlaced = false;
-	const uint8 MAX_ATTEMPTS = 50;
-	int Attempts = 0;
-	while (!bMandatoryRoomsPlaced)
+	for (const FDPoint& Point : Points)
 	{
-		RoomTiles.Init(FRoomTile(), RoomAdjacency.Num());
+		FRoomTile& Tile = State.Tiles[Point.Id];
+		Tile = FRoomTile(Point.Id, FIntPoint(Point.X, Point.Y));
+		Tile.Entropy = CompiledLayoutRules.DomainEntropies[Tile.Domain];
+		State.EntropyQueue.Push(Tile.Id, Tile.Entropy);
+	}
 
-		for (const auto& Point : RoomAdjacency)
-		{
-			RoomTiles[Point.Key.Id] = FRoomTile(Point.Key.Id, FIntPoint(Point.Key.X, Point.Key.Y), &LayoutRules);
-		}
+	// Attempt i is seeded with Seed + i and the lowest attempt that succeeds is used, whether they run one after another
+	// or in parallel
+	const int32 MAX_ATTEMPTS = 50;
+	const int32 Seed = FMath::Rand();
+	bool bRoomsTyped = false;
 
-		// Assign adjacancies to room tiles
-		for (const auto& Point : RoomAdjacency)
-			for (const FDPoint& AdjacentPoint : Point.Value)
-			{
-				RoomTiles[Point.Key.Id].Neighbours.Add(&RoomTiles[AdjacentPoint.Id]);
-			}
-
-		Attempts++;
-		if (Attempts >= MAX_ATTEMPTS)
+	if (ParallelRoomTypingAttempts <= 1)
+	{
+		for (int32 Attempt = 0; Attempt < MAX_ATTEMPTS && !bRoomsTyped; Attempt++)
 		{
-			UE_LOG(LogTemp, Error, TEXT("Failed to place mandatory rooms. WFC failed."));
-			break;
+			bRoomsTyped = TypeRooms(State, RoomGraph, Attempt, Seed + Attempt);
 		}
-
-		//Place spawns first. Then calculate initial entropies
-		for (int x = 0; x < PlayerCount; x++)
+	}
+	else
+	{
+		// Run the attempts in waves, one per worker state. Attempts after the lowest success so far give up early, while
+		// earlier ones keep going as they would still win.
+		const int32 NumWorkers = FMath::Min(ParallelRoomTypingAttempts, MAX_ATTEMPTS);
+		std::atomic<int32> WinningAttempt(MAX_ATTEMPTS);
+
+		TArray<FRoomTypingState> WorkerStates;
+		WorkerStates.Init(State, NumWorkers);
+		for (FRoomTypingState& WorkerState : WorkerStates)
 		{
-			uint8 SpawnIndex = 0;
-			if (!ForcePlaceRoom(ERoomType::Spawn, RoomTiles, CollapsedRooms, SpawnIndex)) continue;
+			WorkerState.WinningAttempt = &WinningAttempt;
 		}
 
-		// Place boss and ascent points
-		uint8 BossIndex = 0;
-		if (!ForcePlaceRoom(ERoomType::Boss, RoomTiles, CollapsedRooms, BossIndex)) continue;
-
-		bool bSuccess = false;
-		uint8 AscentPointIndex = 0;
-
-		for (auto& Neighbour : RoomTiles[BossIndex].Neighbours)
+		TArray<UE::Tasks::TTask<void>> Tasks;
+		for (int32 WaveStart = 0; WaveStart < MAX_ATTEMPTS && WinningAttempt.load() == MAX_ATTEMPTS; WaveStart += NumWorkers)
 		{
-			if (!Neighbour->bCollapsed)
+			Tasks.Reset();
+			for (int32 Worker = 0; Worker < NumWorkers && WaveStart + Worker < MAX_ATTEMPTS; Worker++)
 			{
-				Neighbour->Collapse(ERoomType::AscentPoint);
-				AscentPointIndex = Neighbour->Id;
-				CollapsedRooms++;
-				bSuccess = true;
-				break;
-			}
-		}
-
-		if (!bSuccess) continue;
+				Tasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, &WorkerStates, &RoomGraph, &WinningAttempt, Worker, Seed, Attempt = WaveStart + Worker]()
+				{
+					if (!TypeRooms(WorkerStates[Worker], RoomGraph, Attempt, Seed + Attempt)) return;
 
-		// Remove links to the ascent point that isn't the boss room
-		for (int X = RoomTiles[AscentPointIndex].Neighbours.Num() - 1; X >= 0; X--)
-		{
-			FRoomTile* Neighbour = RoomTiles[AscentPointIndex].Neighbours[X];
-			if (Neighbour->Id != BossIndex)
-			{
-				Neighbour->Neighbours.Remove(&RoomTiles[AscentPointIndex]);
-				RoomTiles[AscentPointIndex].Neighbours.RemoveAt(X);
+					int32 Winner = WinningAttempt.load();
+					while (Attempt < Winner && !WinningAttempt.compare_exchange_weak(Winner, Attempt)) { }
+				}));
 			}
+			UE::Tasks::Wait(Tasks);
 		}
-		
-		if (!IsRoomsConnected(RoomTiles)) continue;
 
-		// Spawns, boss and ascent point have been placed, remove them from the possible room types so no more are spawned
-		for (auto& Room : RoomTiles)
+		const int32 Winner = WinningAttempt.load();
+		if (Winner < MAX_ATTEMPTS)
 		{
-			if (!Room.bCollapsed)
-			{
-				Room.PossibleRoomTypes.Remove(ERoomType::Spawn);
-				Room.PossibleRoomTypes.Remove(ERoomType::Boss);
-				Room.PossibleRoomTypes.Remove(ERoomType::AscentPoint);
-
-				if (Room.PossibleRoomTypes.Num() == 0)
-				{
-					UE_LOG(LogTemp, Error, TEXT("No possible room types. Retrying."));
-					bSuccess = false;
-					break;
-				}
-			}
+			State = MoveTemp(WorkerStates[Winner % NumWorkers]);
+			bRoomsTyped = true;
 		}
+	}
 
-		if (!bSuccess) continue;
-
-		bMandatoryRoomsPlaced = true;
+	if (!bRoomsTyped)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to determine room types. WFC failed."));
+		return;
 	}
 
+	RoomGraph = MoveTemp(State.Graph);
+
 	if (bDebug)
 	{
-		for (const auto& Elem : RoomTiles)
+		for (const auto& Elem : State.Tiles)
 		{
-			for (const auto& Neighbour : Elem.Neighbours)
+			for (const int32 NeighbourIndex : RoomGraph.GetNeighbours(Elem.Id))
 			{
+				const FRoomTile& Neighbour = State.Tiles[NeighbourIndex];
 				UKismetSystemLibrary::DrawDebugLine(
 					this
 					, FVector(Elem.GridPos.X * CellSize, Elem.GridPos.Y * CellSize, 0.f)
-					, FVector(Neighbour->GridPos.X * CellSize, Neighbour->GridPos.Y * CellSize, 0.f)
+					, FVector(Neighbour.GridPos.X * CellSize, Neighbour.GridPos.Y * CellSize, 0.f)
 					, FColor::Green
 					, 500.f
 					, 16.f
@@ -452,153 +679,288 @@ void AMazeGenerator::DetermineRoomTypes(const TMap<FDPoint, TArray<FDPoint>>& Ro
 		}
 	}
 
-	for (auto& Room : RoomTiles)
+	// Construct room data from tiles
+	RoomDataCollection.Empty();
+	for (auto& Room : State.Tiles)
 	{
-		Room.RecalculateEntropy();
+		FRoomData* Data = new FRoomData();
+		Data->Id = Room.Id;
+		Data->RoomType = Room.GetRoomType();
+		Data->GridPos = Room.GridPos;
+		Data->Position = FVector(Data->GridPos.X * CellSize, Data->GridPos.Y * CellSize, 0.f);
+		RoomDataCollection.Add(*Data);
 	}
-	
-	int32 NextIndex = FMath::RandRange(0, RoomDataCollection.Num() - 1);
-	while (CollapsedRooms != RoomTiles.Num())
+
+	SizeRooms(RoomDataCollection);
+}
+
+bool AMazeGenerator::TypeRooms(FRoomTypingState& State, const FRoomGraph& RoomGraph, int32 AttemptIndex, int32 Seed) const
+{
+	// A failed attempt rolls the tiles back to their initial state rather than rebuilding them
+	RollbackTiles(State, 0);
+
+	// Each attempt prunes links from its own copy of the graph
+	State.Graph = RoomGraph;
+	State.Random.Initialize(Seed);
+	State.AttemptIndex = AttemptIndex;
+
+	return PlaceMandatoryRooms(State) && CollapseRooms(State);
+}
+
+bool AMazeGenerator::PlaceMandatoryRooms(FRoomTypingState& State) const
+{
+	//Place spawns first
+	for (int x = 0; x < PlayerCount; x++)
 	{
-		// Collapse tile randomly based on room weights
-		FRoomTile* Next = &RoomTiles[NextIndex];
-		float Roll = FMath::RandRange(0.f, 1.f);
+		int32 SpawnIndex = 0;
+		if (!ForcePlaceRoom(ERoomType::Spawn, State, SpawnIndex)) return false;
+	}
 
-		int PossibilityIndex = 0;
-		while (Roll > 0)
+	// Place boss and ascent points. The ascent point's links to rooms other than the boss are removed before either is
+	// propagated, as propagation would otherwise rule out an ascent point next to the boss.
+	const FRoomGraph UnprunedGraph = State.Graph;
+	const int32 TrailMark = State.Trail.Num();
+	bool bBossPlaced = false;
+	for (uint8 Attempts = 0; Attempts < 20 && !bBossPlaced; Attempts++)
+	{
+		const int32 BossIndex = State.Random.RandRange(0, State.Tiles.Num() - 1);
+		if (State.Tiles[BossIndex].bCollapsed || !State.Tiles[BossIndex].CanBe(ERoomType::Boss)) continue;
+
+		int32 AscentPointIndex = INDEX_NONE;
+		for (const int32 NeighbourIndex : State.Graph.GetNeighbours(BossIndex))
 		{
-			ERoomType RoomType = Next->PossibleRoomTypes[PossibilityIndex];
-			Roll -= LayoutRules.RoomTypeWeights.FindRef(RoomType);
-			PossibilityIndex++;
-			if (Roll <= 0 || PossibilityIndex >= Next->PossibleRoomTypes.Num())
+			const FRoomTile& Neighbour = State.Tiles[NeighbourIndex];
+			if (!Neighbour.bCollapsed && Neighbour.CanBe(ERoomType::AscentPoint))
 			{
-				Next->Collapse(RoomType);
-				CollapsedRooms++;
+				AscentPointIndex = NeighbourIndex;
 				break;
 			}
 		}
 
-		if (!CollapseNeighbours(*Next, CollapsedRooms)) return;
+		// No neighbour can be the ascent point, try another boss room
+		if (AscentPointIndex == INDEX_NONE) continue;
+
+		SetTileDomain(State, BossIndex, ToRoomTypeMask(ERoomType::Boss), true);
+		SetTileDomain(State, AscentPointIndex, ToRoomTypeMask(ERoomType::AscentPoint), true);
 
-		//Set next as the room with the lowest entropy
-		for (int32 i = 0; i < RoomTiles.Num(); i++)
+		// Remove links to the ascent point that isn't the boss room
+		State.Graph.RemoveEdges([AscentPointIndex, BossIndex](int32 A, int32 B) {
+			return (A == AscentPointIndex && B != BossIndex) || (B == AscentPointIndex && A != BossIndex);
+		});
+
+		bBossPlaced = State.Graph.IsConnected() && PropagateConstraints(State, BossIndex) && PropagateConstraints(State, AscentPointIndex);
+		if (!bBossPlaced)
 		{
-			if (RoomTiles[i].bCollapsed) continue;
-			if (RoomTiles[i].Entropy < RoomTiles[NextIndex].Entropy)
-			{
-				NextIndex = i;
-			}
+			RollbackTiles(State, TrailMark);
+			State.Graph = UnprunedGraph;
 		}
 	}
 
-	// Construct room data from tiles
-	RoomDataCollection.Empty();
-	for (auto& Room : RoomTiles)
+	if (!bBossPlaced)
 	{
-		FRoomData* Data = new FRoomData();
-		Data->Id = Room.Id;
-		Data->RoomType = Room.PossibleRoomTypes[0];
-		Data->GridPos = Room.GridPos;
-		Data->Position = FVector(Data->GridPos.X * CellSize, Data->GridPos.Y * CellSize, 0.f);
-		RoomDataCollection.Add(*Data);
+		UE_LOG(LogTemp, Warning, TEXT("Failed to force place."));
+		return false;
 	}
 
-	// Assign neighbours
-	for (auto& Room : RoomDataCollection)
+	// Spawns, boss and ascent point have been placed, remove them from the possible room types so no more are spawned.
+	// The narrowed tiles are then propagated from, so collapsing starts from a consistent state.
+	const FRoomTypeMask MandatoryRoomTypes = ToRoomTypeMask(ERoomType::Spawn) | ToRoomTypeMask(ERoomType::Boss) | ToRoomTypeMask(ERoomType::AscentPoint);
+	TArray<int32> NarrowedTiles;
+	for (const auto& Room : State.Tiles)
 	{
-		for (auto& Neighbour : RoomTiles[Room.Id].Neighbours)
+		if (Room.bCollapsed) continue;
+
+		const FRoomTypeMask Domain = Room.Domain & ~MandatoryRoomTypes;
+		if (Domain == 0)
 		{
-			Room.Neighbours.Add(&RoomDataCollection[Neighbour->Id]);
+			UE_LOG(LogTemp, Warning, TEXT("No possible room types. Retrying."));
+			return false;
+		}
+		if (Domain != Room.Domain)
+		{
+			SetTileDomain(State, Room.Id, Domain, FMath::CountBits(Domain) == 1);
+			NarrowedTiles.Add(Room.Id);
 		}
 	}
 
-	SizeRooms(RoomDataCollection);
+	if (!PropagateConstraints(State, NarrowedTiles))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Mandatory rooms leave no consistent room types. Retrying."));
+		return false;
+	}
+
+	return true;
 }
 
-bool AMazeGenerator::IsRoomsConnected(const TArray<FRoomTile>& Rooms)
+bool AMazeGenerator::CollapseRooms(FRoomTypingState& State) const
 {
-	TArray<FRoomTile> Stack;
-	TArray<bool> Visited;
-	Visited.Init(false, Rooms.Num());
+	// A choice of room type for a tile, and where the trail was before it was made
+	struct FDecision
+	{
+		int32 TrailMark;
+		int32 TileIndex;
+		ERoomType RoomType;
+	};
 
-	Stack.Add(Rooms[0]);
+	TArray<FDecision> Decisions;
+	int32 Backtracks = 0;
 
-	while (Stack.Num() > 0)
+	// Start from a random room, then always collapse the queued room with the lowest entropy
+	int32 NextIndex = State.Random.RandRange(0, State.Tiles.Num() - 1);
+	if (State.Tiles[NextIndex].bCollapsed)
 	{
-		FRoomTile Current = Stack.Pop();
-		Visited[Current.Id] = true;
+		NextIndex = State.EntropyQueue.Pop();
+	}
 
-		for (auto& Neighbour : Current.Neighbours)
+	while (NextIndex != INDEX_NONE)
+	{
+		if (State.IsCancelled()) return false;
+
+		// Collapse tile randomly based on room weights
+		const FRoomTile& Next = State.Tiles[NextIndex];
+		const ERoomType RoomType = CompiledLayoutRules.DomainDistributions[Next.Domain].Sample(State.Random);
+		Decisions.Add({ State.Trail.Num(), NextIndex, RoomType });
+		SetTileDomain(State, NextIndex, ToRoomTypeMask(RoomType), true);
+
+		// On a contradiction, undo the latest choice and rule out the room type it made. If that leaves the tile with
+		// nothing, or contradicts as well, undo the choice before it.
+		bool bConsistent = PropagateConstraints(State, NextIndex);
+		while (!bConsistent)
 		{
-			if (!Visited[Neighbour->Id])
+			if (Decisions.Num() == 0 || Backtracks >= MaxRoomTypingBacktracks)
 			{
-				Stack.Add(*Neighbour);
+				UE_LOG(LogTemp, Warning, TEXT("No possible room types after %d backtracks. Retrying."), Backtracks);
+				return false;
 			}
+
+			Backtracks++;
+			const FDecision Decision = Decisions.Pop(false);
+			RollbackTiles(State, Decision.TrailMark);
+
+			const FRoomTypeMask Remaining = State.Tiles[Decision.TileIndex].Domain & ~ToRoomTypeMask(Decision.RoomType);
+			if (Remaining == 0) continue;
+
+			SetTileDomain(State, Decision.TileIndex, Remaining, FMath::CountBits(Remaining) == 1);
+			bConsistent = PropagateConstraints(State, Decision.TileIndex);
 		}
-	}
 
-	for (auto& VisitedRoom : Visited)
-	{
-		if (!VisitedRoom) return false;
+		NextIndex = State.EntropyQueue.Pop();
 	}
 
 	return true;
 }
 
-bool AMazeGenerator::ForcePlaceRoom(ERoomType RoomType, TArray<FRoomTile>& RoomTiles, uint8& CollapsedRooms, uint8& CollapsedIndex)
+void AMazeGenerator::SetTileDomain(FRoomTypingState& State, int32 TileIndex, FRoomTypeMask Domain, bool bCollapsed) const
 {
-	// Find a node that allows for a spawn point
-	uint8 Attempts = 0;
-	while (Attempts < 20)
+	FRoomTile& Tile = State.Tiles[TileIndex];
+	State.Trail.Add({ TileIndex, Tile.Domain, Tile.bCollapsed });
+
+	Tile.Domain = Domain;
+	Tile.bCollapsed = bCollapsed;
+	Tile.Entropy = CompiledLayoutRules.DomainEntropies[Domain];
+
+	// Only tiles that are still open are queued for collapsing
+	if (bCollapsed)
 	{
-		Attempts++;
-		CollapsedIndex = FMath::RandRange(0, RoomTiles.Num() - 1);
-		if (!RoomTiles[CollapsedIndex].bCollapsed && RoomTiles[CollapsedIndex].PossibleRoomTypes.Contains(RoomType))
+		State.EntropyQueue.Remove(TileIndex);
+	}
+	else if (!State.EntropyQueue.Update(TileIndex, Tile.Entropy))
+	{
+		State.EntropyQueue.Push(TileIndex, Tile.Entropy);
+	}
+}
+
+void AMazeGenerator::RollbackTiles(FRoomTypingState& State, int32 TrailMark) const
+{
+	while (State.Trail.Num() > TrailMark)
+	{
+		const FRoomTileChange Change = State.Trail.Pop(false);
+		FRoomTile& Tile = State.Tiles[Change.TileIndex];
+
+		Tile.Domain = Change.Domain;
+		Tile.bCollapsed = Change.bCollapsed;
+		Tile.Entropy = CompiledLayoutRules.DomainEntropies[Change.Domain];
+
+		if (Tile.bCollapsed)
 		{
-			break;
+			State.EntropyQueue.Remove(Change.TileIndex);
+		}
+		else if (!State.EntropyQueue.Update(Change.TileIndex, Tile.Entropy))
+		{
+			State.EntropyQueue.Push(Change.TileIndex, Tile.Entropy);
 		}
 	}
+}
 
-	if (Attempts >= 20)
+bool AMazeGenerator::ForcePlaceRoom(ERoomType RoomType, FRoomTypingState& State, int32& CollapsedIndex) const
+{
+	// Find a node that allows for the room type, undoing any placement that contradicts its neighbours
+	const int32 TrailMark = State.Trail.Num();
+	for (uint8 Attempts = 0; Attempts < 20; Attempts++)
 	{
-		UE_LOG(LogTemp, Error, TEXT("Failed to force place."));
-		return false;
+		CollapsedIndex = State.Random.RandRange(0, State.Tiles.Num() - 1);
+		const FRoomTile& Tile = State.Tiles[CollapsedIndex];
+		if (Tile.bCollapsed || !Tile.CanBe(RoomType)) continue;
+
+		SetTileDomain(State, CollapsedIndex, ToRoomTypeMask(RoomType), true);
+		if (PropagateConstraints(State, CollapsedIndex)) return true;
+
+		RollbackTiles(State, TrailMark);
 	}
 
-	RoomTiles[CollapsedIndex].Collapse(RoomType);
-	if (!CollapseNeighbours(RoomTiles[CollapsedIndex], CollapsedRooms)) return false;
-	return true;
+	UE_LOG(LogTemp, Warning, TEXT("Failed to force place."));
+	return false;
+}
+
+bool AMazeGenerator::PropagateConstraints(FRoomTypingState& State, int32 TileIndex) const
+{
+	return PropagateConstraints(State, MakeArrayView(&TileIndex, 1));
 }
 
-bool AMazeGenerator::CollapseNeighbours(FRoomTile& Tile, uint8& CollapsedRooms)
+bool AMazeGenerator::PropagateConstraints(FRoomTypingState& State, TConstArrayView<int32> TileIndices) const
 {
-	// Update neighbours
-	for (auto Neighbour : Tile.Neighbours)
+	// AC-3 style propagation. Whenever a tile's domain shrinks it is queued to narrow its own neighbours in turn, until
+	// nothing changes. A tile is only ever in the worklist once, so it never holds more entries than there are tiles.
+	TArray<int32, TInlineAllocator<64>> Worklist;
+	for (const int32 TileIndex : TileIndices)
+	{
+		if (State.Tiles[TileIndex].bQueued) continue;
+
+		Worklist.Add(TileIndex);
+		State.Tiles[TileIndex].bQueued = true;
+	}
+
+	while (Worklist.Num() > 0)
 	{
-		if (Neighbour->bCollapsed) continue;
-		for (int x = Neighbour->PossibleRoomTypes.Num() - 1; x >= 0; x--)
+		const int32 Current = Worklist.Pop(false);
+		State.Tiles[Current].bQueued = false;
+		const FRoomTypeMask Compatible = CompiledLayoutRules.CompatibleRoomTypes[State.Tiles[Current].Domain];
+
+		for (const int32 NeighbourIndex : State.Graph.GetNeighbours(Current))
 		{
-			ERoomType NeighbourOption = Neighbour->PossibleRoomTypes[x];
-			if (!LayoutRules.RoomEntropy.FindRef(NeighbourOption).Possibilities.Contains(Tile.PossibleRoomTypes[0]))
+			// Collapsed neighbours are checked too, as two neighbours can collapse during the same propagation
+			const FRoomTile& Neighbour = State.Tiles[NeighbourIndex];
+			const FRoomTypeMask Narrowed = Neighbour.Domain & Compatible;
+			if (Narrowed == Neighbour.Domain) continue;
+
+			// If the neighbour has no possible room types left, this branch of WFC has failed
+			if (Narrowed == 0)
 			{
-				Neighbour->PossibleRoomTypes.RemoveAt(x);
+				for (const int32 Queued : Worklist)
+				{
+					State.Tiles[Queued].bQueued = false;
+				}
+				return false;
 			}
-		}
 
-		Neighbour->RecalculateEntropy();
+			// If the neighbour only has one possible room type left, collapse it
+			SetTileDomain(State, NeighbourIndex, Narrowed, FMath::CountBits(Narrowed) == 1);
 
-		// If the neighbour only has one possible room type left, collapse it
-		if (Neighbour->PossibleRoomTypes.Num() == 1)
-		{
-			Neighbour->bCollapsed = true;
-			CollapseNeighbours(*Neighbour, CollapsedRooms);
-			CollapsedRooms++;
-		}
-		// If the neighbour has no possible room types left, WFC has failed
-		else if (Neighbour->PossibleRoomTypes.Num() == 0)
-		{
-			UE_LOG(LogTemp, Error, TEXT("No possible room types. WFC failed."));
-			return false;
+			if (!Neighbour.bQueued)
+			{
+				State.Tiles[NeighbourIndex].bQueued = true;
+				Worklist.Add(NeighbourIndex);
+			}
 		}
 	}
 	return true;
@@ -615,7 +977,7 @@ void AMazeGenerator::SizeRooms(TArray<FRoomData>& RoomDataCollection)
 		for (FRoomData& Room : RoomDataCollection)
 		{
 			F2DRange& Corners = Room.Corners;
-			const F2DRange& RoomSizeRange = LayoutRules.RoomSizes[Room.RoomType];
+			const F2DRange& RoomSizeRange = CompiledLayoutRules.RoomSizes[(uint8)Room.RoomType];
 			uint32 RoomLength = RoundToOdd(FMath::RandRange(RoomSizeRange.MinX, RoomSizeRange.MaxX));
 			uint32 RoomWidth = RoundToOdd(FMath::RandRange(RoomSizeRange.MinY, RoomSizeRange.MaxY));
 			Corners.MinX = FMath::Clamp(Room.GridPos.X - ((RoomLength / 2)), 0, Length);
@@ -642,25 +1004,136 @@ void AMazeGenerator::SizeRooms(TArray<FRoomData>& RoomDataCollection)
 		});
 
 
+	if (RoomSizingMode == ERoomSizingMode::Packed)
+	{
+		PackRooms(RoomDataCollection);
+	}
+	else if (!PushRoomsApart(RoomDataCollection))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to move rooms apart."));
+	}
+
+	for (auto& Data : RoomDataCollection)
+	{
+		if (bDebug)
+		{
+			const TMap<ERoomType, FColor> RoomTypeColours = {
+				{ ERoomType::Spawn, FColor::Magenta },
+				{ ERoomType::Boss, FColor::Orange },
+				{ ERoomType::Treasure, FColor::Yellow },
+				{ ERoomType::Normal, FColor::White },
+				{ ERoomType::AscentPoint, FColor::Blue },
+			};
+
+			UKismetSystemLibrary::DrawDebugBox(
+				this
+				, Data.Position
+				, FVector((Data.Corners.Length()) * CellSize / 2, (Data.Corners.Width()) * CellSize / 2, 0.f)
+				, RoomTypeColours.FindRef(Data.RoomType)
+				, FRotator::ZeroRotator
+				, 500.f
+			);
+
+		}
+	}
+}
+
+bool AMazeGenerator::PushRoomsApart(TArray<FRoomData>& RoomDataCollection)
+{
 	// Move overlapping rooms out towards the edges, from the middle outwards
 	bool bOverlapsExist = true;
 	uint8 Attempts = 0;
-	const uint8 MIN_SPACING = 10;
 	const uint8 MAX_ATTEMPTS = 15;
 	UE_LOG(LogTemp, Warning, TEXT("Overlap checks"))
 
+	const auto Overlaps = [](const FRoomData& RoomOne, const FRoomData& RoomTwo) {
+		return RoomOne.GridPos.X < RoomTwo.GridPos.X + RoomTwo.Corners.Length() &&
+			RoomOne.GridPos.X + RoomOne.Corners.Length() > RoomTwo.GridPos.X &&
+			RoomOne.GridPos.Y < RoomTwo.GridPos.Y + RoomTwo.Corners.Width() &&
+			RoomOne.GridPos.Y + RoomOne.Corners.Width() > RoomTwo.GridPos.Y;
+	};
+
+	// Broad phase. Rooms are hashed into cells at least as big as the largest room, so a room only covers up to
+	// two cells on each axis and only rooms sharing a cell need the overlap test. Moving a room never changes its
+	// size, so the cell size holds for the whole separation.
+	int32 HashCellSize = 1;
+	for (const auto& Room : RoomDataCollection)
+	{
+		HashCellSize = FMath::Max3(HashCellSize, Room.Corners.Length(), Room.Corners.Width());
+	}
+
+	const auto GetCells = [HashCellSize](const FRoomData& Room) {
+		const FIntPoint MinCell(
+			FMath::FloorToInt((float)Room.GridPos.X / HashCellSize),
+			FMath::FloorToInt((float)Room.GridPos.Y / HashCellSize));
+		const FIntPoint MaxCell(
+			FMath::FloorToInt((float)(Room.GridPos.X + FMath::Max(Room.Corners.Length() - 1, 0)) / HashCellSize),
+			FMath::FloorToInt((float)(Room.GridPos.Y + FMath::Max(Room.Corners.Width() - 1, 0)) / HashCellSize));
+		return FIntRect(MinCell, MaxCell);
+	};
+
+	TMap<FIntPoint, TArray<int32>> RoomsByCell;
+	const auto AddToCells = [&RoomsByCell, &GetCells, &RoomDataCollection](int32 RoomIndex) {
+		const FIntRect Cells = GetCells(RoomDataCollection[RoomIndex]);
+		for (int32 X = Cells.Min.X; X <= Cells.Max.X; X++)
+		{
+			for (int32 Y = Cells.Min.Y; Y <= Cells.Max.Y; Y++)
+			{
+				RoomsByCell.FindOrAdd(FIntPoint(X, Y)).Add(RoomIndex);
+			}
+		}
+	};
+	const auto RemoveFromCells = [&RoomsByCell, &GetCells, &RoomDataCollection](int32 RoomIndex) {
+		const FIntRect Cells = GetCells(RoomDataCollection[RoomIndex]);
+		for (int32 X = Cells.Min.X; X <= Cells.Max.X; X++)
+		{
+			for (int32 Y = Cells.Min.Y; Y <= Cells.Max.Y; Y++)
+			{
+				RoomsByCell.FindChecked(FIntPoint(X, Y)).RemoveSingleSwap(RoomIndex, false);
+			}
+		}
+	};
+
+	for (int32 i = 0; i < RoomDataCollection.Num(); i++)
+	{
+		AddToCells(i);
+	}
+
+	// Rooms keep their place in the centre-out order for the whole separation, so candidates are visited in that
+	// order and a room sharing several cells with another is only tested once per sweep
+	TArray<int32> Candidates;
+	TArray<int32> LastTestedBy;
+
 	while (bOverlapsExist && Attempts < MAX_ATTEMPTS)
 	{
+		// Stamps from the last sweep would skip pairs this one still has to test
+		LastTestedBy.Init(INDEX_NONE, RoomDataCollection.Num());
 		bOverlapsExist = false;
-		for (auto& RoomOne : RoomDataCollection)
+		for (int32 i = 0; i < RoomDataCollection.Num(); i++)
 		{
-			for (auto& RoomTwo : RoomDataCollection)
+			const FRoomData& RoomOne = RoomDataCollection[i];
+
+			Candidates.Reset();
+			const FIntRect Cells = GetCells(RoomOne);
+			for (int32 X = Cells.Min.X; X <= Cells.Max.X; X++)
+			{
+				for (int32 Y = Cells.Min.Y; Y <= Cells.Max.Y; Y++)
+				{
+					for (int32 j : RoomsByCell.FindChecked(FIntPoint(X, Y)))
+					{
+						if (j == i || LastTestedBy[j] == i) continue;
+
+						LastTestedBy[j] = i;
+						Candidates.Add(j);
+					}
+				}
+			}
+			Candidates.Sort();
+
+			for (int32 j : Candidates)
 			{
-				if (RoomOne.Id != RoomTwo.Id && 
-					RoomOne.GridPos.X < RoomTwo.GridPos.X + RoomTwo.Corners.Length() &&
-					RoomOne.GridPos.X + RoomOne.Corners.Length() > RoomTwo.GridPos.X &&
-					RoomOne.GridPos.Y < RoomTwo.GridPos.Y + RoomTwo.Corners.Width() &&
-					RoomOne.GridPos.Y + RoomOne.Corners.Width() > RoomTwo.GridPos.Y)
+				FRoomData& RoomTwo = RoomDataCollection[j];
+				if (Overlaps(RoomOne, RoomTwo))
 				{
 					bOverlapsExist = true;
 
@@ -672,45 +1145,192 @@ void AMazeGenerator::SizeRooms(TArray<FRoomData>& RoomDataCollection)
 					int TranslationX = ((MaxLength) - FMath::Abs(XDistance)) * FMath::Sign(XDistance);
 					int TranslationY = ((MaxWidth) - FMath::Abs(YDistance)) * FMath::Sign(YDistance);
 
+					RemoveFromCells(j);
 					MoveRoomOnGrid(RoomTwo, RoomTwo.GridPos + FIntPoint(TranslationX, TranslationY));
-
-					RoomDataCollection.Sort([AveragePos](const FRoomData& A, const FRoomData& B) {
-						return Distance(A.GridPos, AveragePos) < Distance(B.GridPos, AveragePos);
-						});
-						
+					AddToCells(j);
 				}
-				
 			}
 		}
 		Attempts++;
 	}
 
-	if (bOverlapsExist || Attempts >= MAX_ATTEMPTS)
+	return !bOverlapsExist && Attempts < MAX_ATTEMPTS;
+}
+
+void AMazeGenerator::PackRooms(TArray<FRoomData>& RoomDataCollection)
+{
+	const int32 MIN_SPACING = 10;
+
+	// Rooms cover [Min, Max) on each axis and keep MIN_SPACING clear cells between them
+	const auto Conflicts = [&](const F2DRange& A, const F2DRange& B) {
+		return A.MinX < B.MaxX + MIN_SPACING && B.MinX < A.MaxX + MIN_SPACING &&
+			A.MinY < B.MaxY + MIN_SPACING && B.MinY < A.MaxY + MIN_SPACING;
+	};
+
+	const auto GetCornersAt = [](const FRoomData& Room, FIntPoint GridPos) {
+		const int32 HalfLength = Room.Corners.Length() / 2;
+		const int32 HalfWidth = Room.Corners.Width() / 2;
+
+		F2DRange Corners;
+		Corners.MinX = GridPos.X - HalfLength;
+		Corners.MaxX = GridPos.X + HalfLength;
+		Corners.MinY = GridPos.Y - HalfWidth;
+		Corners.MaxY = GridPos.Y + HalfWidth;
+		return Corners;
+	};
+
+	// Placed rooms are hashed into cells big enough that a room and its spacing only reach the neighbouring cells
+	int32 HashCellSize = 1;
+	for (const auto& Room : RoomDataCollection)
 	{
-		UE_LOG(LogTemp, Error, TEXT("Failed to move rooms apart."));
+		HashCellSize = FMath::Max3(HashCellSize, Room.Corners.Length() + MIN_SPACING, Room.Corners.Width() + MIN_SPACING);
 	}
 
-	for (auto& Data : RoomDataCollection)
+	TMap<FIntPoint, TArray<int32>> PlacedByCell;
+	const auto GetCell = [HashCellSize](int32 X, int32 Y) {
+		return FIntPoint(FMath::FloorToInt((float)X / HashCellSize), FMath::FloorToInt((float)Y / HashCellSize));
+	};
+
+	// Gathers the bounds of every placed room too close to the given corners, returning whether there were any
+	const auto FindConflicts = [&](const F2DRange& Corners, F2DRange& OutBlockers) {
+		bool bConflicts = false;
+		const FIntPoint MinCell = GetCell(Corners.MinX - MIN_SPACING, Corners.MinY - MIN_SPACING);
+		const FIntPoint MaxCell = GetCell(Corners.MaxX + MIN_SPACING, Corners.MaxY + MIN_SPACING);
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			{
+				const TArray<int32>* Placed = PlacedByCell.Find(FIntPoint(X, Y));
+				if (!Placed) continue;
+
+				for (int32 Index : *Placed)
+				{
+					const F2DRange& Other = RoomDataCollection[Index].Corners;
+					if (!Conflicts(Corners, Other)) continue;
+
+					if (!bConflicts)
+					{
+						OutBlockers = Other;
+						bConflicts = true;
+						continue;
+					}
+					OutBlockers.MinX = FMath::Min(OutBlockers.MinX, Other.MinX);
+					OutBlockers.MaxX = FMath::Max(OutBlockers.MaxX, Other.MaxX);
+					OutBlockers.MinY = FMath::Min(OutBlockers.MinY, Other.MinY);
+					OutBlockers.MaxY = FMath::Max(OutBlockers.MaxY, Other.MaxY);
+				}
+			}
+		}
+		return bConflicts;
+	};
+
+	// Moves from a position too close to placed rooms along one of the four axis directions to the first position
+	// that clears all of them, as anything in between still touches one of them
+	const int32 NUM_DIRECTIONS = 4;
+	const auto GetClearingMove = [&](const FIntPoint& GridPos, const F2DRange& Blockers, int32 HalfLength, int32 HalfWidth, int32 Direction) {
+		switch (Direction)
+		{
+		case 0: return FIntPoint(Blockers.MaxX + MIN_SPACING + HalfLength, GridPos.Y);
+		case 1: return FIntPoint(Blockers.MinX - MIN_SPACING - HalfLength, GridPos.Y);
+		case 2: return FIntPoint(GridPos.X, Blockers.MaxY + MIN_SPACING + HalfWidth);
+		default: return FIntPoint(GridPos.X, Blockers.MinY - MIN_SPACING - HalfWidth);
+		}
+	};
+
+	struct FPackCandidate
 	{
-		if (bDebug)
+		int64 DistanceSquared;
+		FIntPoint GridPos;
+	};
+	const auto IsCloser = [](const FPackCandidate& A, const FPackCandidate& B) {
+		return A.DistanceSquared < B.DistanceSquared;
+	};
+
+	const auto GetDistanceSquared = [](const FIntPoint& A, const FIntPoint& B) {
+		const FIntPoint Offset = A - B;
+		return (int64)Offset.X * Offset.X + (int64)Offset.Y * Offset.Y;
+	};
+
+	// How many positions a room tries nearest first before falling back to the nearest clear spot straight along an axis
+	const int32 MAX_PACK_CANDIDATES = 64;
+
+	TArray<FPackCandidate> Candidates;
+	TSet<FIntPoint> Visited;
+
+	// From the middle outwards, put each room at a free position near where it was placed. Positions only ever land on
+	// coordinates that clear some placed room, and moving one way along an axis passes the outermost placed room
+	// after at most one move per room, so every room is placed in bounded time.
+	for (int32 i = 0; i < RoomDataCollection.Num(); i++)
+	{
+		FRoomData& Room = RoomDataCollection[i];
+		const FIntPoint Desired = Room.GridPos;
+		const int32 HalfLength = Room.Corners.Length() / 2;
+		const int32 HalfWidth = Room.Corners.Width() / 2;
+
+		Candidates.Reset();
+		Visited.Reset();
+		Candidates.HeapPush({ 0, Desired }, IsCloser);
+		Visited.Add(Desired);
+
+		bool bPlaced = false;
+		FIntPoint Placement = Desired;
+		for (int32 Tries = 0; Tries < MAX_PACK_CANDIDATES && Candidates.Num() > 0; Tries++)
 		{
-			const TMap<ERoomType, FColor> RoomTypeColours = {
-				{ ERoomType::Spawn, FColor::Magenta },
-				{ ERoomType::Boss, FColor::Orange },
-				{ ERoomType::Treasure, FColor::Yellow },
-				{ ERoomType::Normal, FColor::White },
-				{ ERoomType::AscentPoint, FColor::Blue },
-			};
+			FPackCandidate Candidate;
+			Candidates.HeapPop(Candidate, IsCloser, false);
 
-			UKismetSystemLibrary::DrawDebugBox(
-				this
-				, Data.Position
-				, FVector((Data.Corners.Length()) * CellSize / 2, (Data.Corners.Width()) * CellSize / 2, 0.f)
-				, RoomTypeColours.FindRef(Data.RoomType)
-				, FRotator::ZeroRotator
-				, 500.f
-			);
+			F2DRange Blockers;
+			if (!FindConflicts(GetCornersAt(Room, Candidate.GridPos), Blockers))
+			{
+				Placement = Candidate.GridPos;
+				bPlaced = true;
+				break;
+			}
+
+			for (int32 Direction = 0; Direction < NUM_DIRECTIONS; Direction++)
+			{
+				const FIntPoint Next = GetClearingMove(Candidate.GridPos, Blockers, HalfLength, HalfWidth, Direction);
+				bool bAlreadyVisited = false;
+				Visited.Add(Next, &bAlreadyVisited);
+				if (bAlreadyVisited) continue;
+
+				Candidates.HeapPush({ GetDistanceSquared(Next, Desired), Next }, IsCloser);
+			}
+		}
+
+		// Crowded spots can have more nearby positions than are worth trying, so walk straight out along each axis
+		// instead and take the nearest
+		if (!bPlaced)
+		{
+			int64 BestDistanceSquared = MAX_int64;
+			for (int32 Direction = 0; Direction < NUM_DIRECTIONS; Direction++)
+			{
+				FIntPoint GridPos = Desired;
+				F2DRange Blockers;
+				while (FindConflicts(GetCornersAt(Room, GridPos), Blockers))
+				{
+					GridPos = GetClearingMove(GridPos, Blockers, HalfLength, HalfWidth, Direction);
+				}
 
+				const int64 DistanceSquared = GetDistanceSquared(GridPos, Desired);
+				if (DistanceSquared < BestDistanceSquared)
+				{
+					BestDistanceSquared = DistanceSquared;
+					Placement = GridPos;
+				}
+			}
+		}
+
+		MoveRoomOnGrid(Room, Placement);
+
+		const FIntPoint MinCell = GetCell(Room.Corners.MinX, Room.Corners.MinY);
+		const FIntPoint MaxCell = GetCell(Room.Corners.MaxX, Room.Corners.MaxY);
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			{
+				PlacedByCell.FindOrAdd(FIntPoint(X, Y)).Add(i);
+			}
 		}
 	}
 }
@@ -720,7 +1340,7 @@ bool AMazeGenerator::MoveRoomOnGrid(FRoomData& Tile, FIntPoint NewGridPos)
 	uint32 RoomLength = Tile.Corners.MaxX - Tile.Corners.MinX;
 	uint32 RoomWidth = Tile.Corners.MaxY - Tile.Corners.MinY;
 
-	UE_LOG(LogTemp, Warning, TEXT("Moved room from %f %f to %f %f"), Tile.GridPos.X, Tile.GridPos.Y, NewGridPos.X, NewGridPos.Y)
+	UE_LOG(LogTemp, Verbose, TEXT("Moved room from %d %d to %d %d"), Tile.GridPos.X, Tile.GridPos.Y, NewGridPos.X, NewGridPos.Y)
 	Tile.GridPos = NewGridPos;
 	Tile.Position = FVector(Tile.GridPos.X * CellSize, Tile.GridPos.Y * CellSize, 0.f);
 
@@ -741,32 +1361,31 @@ int32 AMazeGenerator::RoundToOdd(int32 Value)
 
 #pragma region Build Corridors
 
-void AMazeGenerator::BuildLinks(TArray<FRoomData>& RoomDataCollection)
+void AMazeGenerator::BuildLinks(TArray<FRoomData>& RoomDataCollection, const FRoomGraph& RoomGraph)
 {
-	TArray<FRoomData> Stack;
-	TArray<bool> Visited;
-	TArray<FLinkData> Links;
-	Visited.Init(false, RoomDataCollection.Num());
-
-	Stack.Add(RoomDataCollection[0]);
-
-	while (Stack.Num() > 0)
+	// Sizing reorders the rooms, so look them up by id
+	TArray<FRoomData*> RoomsById;
+	RoomsById.SetNumZeroed(RoomGraph.Num());
+	for (auto& Room : RoomDataCollection)
 	{
-		FRoomData Current = Stack.Pop();
-		Visited[Current.Id] = true;
+		RoomsById[Room.Id] = &Room;
+	}
 
-		for (auto& Neighbour : Current.Neighbours)
+	// Every edge is stored from both ends, keep the copy leaving the lower index
+	TArray<FLinkData> Links;
+	Links.Reserve(RoomGraph.Neighbours.Num() / 2);
+	for (int32 Room = 0; Room < RoomGraph.Num(); Room++)
+	{
+		for (const int32 Neighbour : RoomGraph.GetNeighbours(Room))
 		{
-			Links.AddUnique(FLinkData(&Current, Neighbour));
-
-			if (!Visited[Neighbour->Id])
+			if (Room < Neighbour)
 			{
-				Stack.Add(*Neighbour);
+				Links.Add(FLinkData(RoomsById[Room], RoomsById[Neighbour]));
 			}
 		}
 	}
 
-	Grid PathGrid = Grid(Length, Width); // Rooms can be pushed out of bounds of this
+	Grid PathGrid = Grid(Length, Width, bTilePathGrid); // Rooms can be pushed out of bounds of this
 
 	for (auto& Room : RoomDataCollection)
 	{
@@ -774,16 +1393,58 @@ void AMazeGenerator::BuildLinks(TArray<FRoomData>& RoomDataCollection)
 		{
 			for (int Y = Room.Corners.MinY; Y < Room.Corners.MaxY; Y++)
 			{
-				//PathGrid[X][Y].IsWalkable = false;
+				//PathGrid.SetWalkable(PathGrid.GetIndex(FIntPoint(X, Y)), false);
 			}
 		}
 	}
-	
-	for (auto& Link : Links)
+
+	// Jump point search follows distances worked out once for the whole grid
+	FJumpDistances JumpDistances;
+	if (CorridorSearchMode == ECorridorSearchMode::JumpPoint)
 	{
-		PopulateLinkPath(Link, PathGrid);
+		BuildJumpDistances(PathGrid, JumpDistances);
+	}
 
-		if (bDebug)
+	// Workers share the grid and jump distances, which nothing writes to while routing, and each searches with its own
+	// state. A link's path depends only on the link, so it comes out the same whichever worker routes it. Search state
+	// is as big as the grid, so large grids run fewer workers to bound how much of it there is at once.
+	const int64 MAX_SEARCH_STATE_BYTES = 256 * 1024 * 1024;
+	const int32 MaxWorkersForGrid = (int32)FMath::Max<int64>(1, MAX_SEARCH_STATE_BYTES / (FMath::Max<int64>(PathGrid.Num(), 1) * FPathSearchState::BYTES_PER_CELL));
+	const int32 NumWorkers = FMath::Min3(ParallelCorridorSearches > 0 ? ParallelCorridorSearches : FTaskGraphInterface::Get().GetNumWorkerThreads(), MaxWorkersForGrid, Links.Num());
+	if (NumWorkers <= 1)
+	{
+		FPathSearchState Search(PathGrid.Num());
+		for (auto& Link : Links)
+		{
+			PopulateLinkPath(Link, PathGrid, JumpDistances, Search);
+		}
+	}
+	else
+	{
+		// Links vary a lot in length, so workers take the next unrouted link as they finish rather than a fixed share
+		std::atomic<int32> NextLink(0);
+		TArray<UE::Tasks::TTask<void>> Tasks;
+		for (int32 Worker = 0; Worker < NumWorkers; Worker++)
+		{
+			Tasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, &Links, &PathGrid, &JumpDistances, &NextLink]()
+			{
+				// Search state is as big as the grid, so only allocate it once there is a link to route
+				int32 LinkIndex = NextLink++;
+				if (LinkIndex >= Links.Num()) return;
+
+				FPathSearchState Search(PathGrid.Num());
+				for (; LinkIndex < Links.Num(); LinkIndex = NextLink++)
+				{
+					PopulateLinkPath(Links[LinkIndex], PathGrid, JumpDistances, Search);
+				}
+			}));
+		}
+		UE::Tasks::Wait(Tasks);
+	}
+
+	if (bDebug)
+	{
+		for (const auto& Link : Links)
 		{
 			FIntPoint Prev = FIntPoint::ZeroValue;
 			for (FIntPoint Point : Link.Path)
@@ -804,176 +1465,146 @@ void AMazeGenerator::BuildLinks(TArray<FRoomData>& RoomDataCollection)
 	}
 }
 
-// Jump Point Search algorithm to find the shortest path between two rooms
-void AMazeGenerator::PopulateLinkPath(FLinkData& Link, Grid& PathGrid) 
-{
-	//const TMap<FIntPoint, TArray<FIntPoint>> ValidDirections = { 
-	//	{ FIntPoint(0, -1), TArray<FIntPoint> { FIntPoint(-1, 0), FIntPoint(-1, -1), FIntPoint(0, -1), FIntPoint(1, -1), FIntPoint(1, 0)} },
-	//	{ FIntPoint(1, -1), TArray<FIntPoint> { FIntPoint(0, -1), FIntPoint(1, -1), FIntPoint(1, 0) } },
-	//	{ FIntPoint(1, 0), TArray<FIntPoint> { FIntPoint(0, -1), FIntPoint(1, -1), FIntPoint(1, 0), FIntPoint(1, 1), FIntPoint(0, 1) } },
-	//	{ FIntPoint(1, 1), TArray<FIntPoint> { FIntPoint(1, 0), FIntPoint(1, 1), FIntPoint(0, 1) } },
-	//	{ FIntPoint(0, 1), TArray<FIntPoint> { FIntPoint(1, 0), FIntPoint(1, 1), FIntPoint(0, 1), FIntPoint(-1, 1), FIntPoint(-1, 0) }},
-	//	{ FIntPoint(-1, 1), TArray<FIntPoint> { FIntPoint(0, 1), FIntPoint(-1, 1), FIntPoint(-1, 0)}},
-	//	{ FIntPoint(-1, 0), TArray<FIntPoint> { FIntPoint(0, 1), FIntPoint(-1, 1), FIntPoint(-1, 0), FIntPoint(-1, -1), FIntPoint(0, -1) } },
-	//	{ FIntPoint(-1, -1), TArray<FIntPoint> { FIntPoint(-1, 0), FIntPoint(-1, -1), FIntPoint(0, -1)} }
-	//};
-
-	//FIntPoint StartPoint = GetClosestRoomEdge(*Link.RoomA, *Link.RoomB);
-	//FIntPoint EndPoint = GetClosestRoomEdge(*Link.RoomB, *Link.RoomA);
-	//FPathCell& StartNode = PathGrid[StartPoint.X][StartPoint.Y];
-	//FPathCell& EndNode = PathGrid[EndPoint.X][EndPoint.Y];
-	//StartNode.hCost = Distance(StartPoint, EndPoint);
-	//StartNode.gCost = 0;
-	//TArray<FPathCell*> OpenList;
-	//OpenList.Add(&StartNode);
-	//int32 Attempts = 0;
-	//if (StartNode.GridPos == EndNode.GridPos)
-	//{
-	//	return;
-	//}
-	//while (OpenList.Num() > 0)
-	//{
-	//	FPathCell* CurNode = GetLowestCostCell(OpenList);
-	//	FPathCell* ParentNode = CurNode->Parent;
-	//	if (CurNode->GridPos == EndNode.GridPos)
-	//	{
-	//		Link.Path = ConstructPath(EndNode);
-	//		return;
-	//	}
-
-	//	OpenList.Remove(CurNode);
-	//	FIntPoint MovingDirection = ParentNode == nullptr ? GetGeneralDirection(CurNode->GridPos, EndNode.GridPos) : GetGeneralDirection(ParentNode->GridPos, CurNode->GridPos);
-	//	for (FIntPoint Direction : ValidDirections[MovingDirection])
-	//	{
-	//		double GCost = 0.0;
-	//		FPathCell* NewSuccesor = nullptr;
-	//		if (IsCardinal(Direction) && IsInExactDirection(CurNode->GridPos, EndNode.GridPos, Direction) && Distance(CurNode->GridPos, EndNode.GridPos) <= DistanceToWall(*CurNode, Direction, PathGrid))
-	//		{
-	//			NewSuccesor = &EndNode;
-	//			GCost = CurNode->gCost + (Distance(CurNode->GridPos, EndNode.GridPos));
-	//		}
-	//		else if (IsDiagonal(Direction) && IsInExactDirection(CurNode->GridPos, EndNode.GridPos, Direction) && FMath::Abs(CurNode->GridPos.X - EndNode.GridPos.X) <= DistanceToWall(*CurNode, Direction, PathGrid) || FMath::Abs(CurNode->GridPos.Y - EndNode.GridPos.Y) <= DistanceToWall(*CurNode, Direction, PathGrid))
-	//		{
-	//			double MinDiff = FMath::Min(FMath::Abs(CurNode->GridPos.X - EndNode.GridPos.X), FMath::Abs(CurNode->GridPos.Y - EndNode.GridPos.Y));
-	//			NewSuccesor = GetNeighbour(CurNode->GridPos, Direction, MinDiff, PathGrid);
-	//			GCost = CurNode->gCost + FMath::Sqrt(MinDiff);
-	//		}
-	//		else if (DistanceToWall(*CurNode, Direction, PathGrid) > 0)
-	//		{
-	//			NewSuccesor = GetNeighbour(CurNode->GridPos, Direction, 1, PathGrid);
-	//			GCost = Distance(CurNode->GridPos, NewSuccesor->GridPos);
-	//			if (IsDiagonal(Direction)) GCost = FMath::Sqrt(GCost);
-	//			else GCost += CurNode->gCost;
-	//		}
-	//		if (NewSuccesor != nullptr)
-	//		{
-	//			if (GCost < NewSuccesor->gCost)
-	//			{
-	//				NewSuccesor->Parent = CurNode;
-	//				NewSuccesor->gCost = GCost;
-	//				NewSuccesor->hCost = Distance(EndNode.GridPos, NewSuccesor->GridPos);
-	//		
-	//				if (!OpenList.Contains(NewSuccesor))
-	//				{
-	//					OpenList.AddUnique(NewSuccesor);
-	//				}
-	//			}
-	//		}
-	//		Attempts++;
-	//		if (Attempts > 1000)
-	//		{
-	//			UE_LOG(LogTemp, Error, TEXT("Failed to find path."))
-	//			break;
-	//		}
-	//	}
-
-		//Node goalNode = pathfindingGrid[end.x, end.y];
-		//List<Node> openList = new List<Node>();
-		//Node startNode = pathfindingGrid[start.x, start.y];
-		//startNode.hCost = startNode - goalNode;
-		//startNode.gCost = 0;
-		//openList.Add(startNode);
-
-		//while (openList.Count > 0)
-		//{
-		//	Node curNode = openList.Aggregate((curMin, x) = > curMin == null || x.fCost < curMin.fCost ? x : curMin);
-		//	Node parentNode = curNode.parent;
-
-		//	if (curNode == goalNode)
-		//		return ConstructPath(goalNode);
-
-		//	openList.Remove(curNode);
-
-		//	foreach(Node neighbour in curNode.GetNeighbours())
-		//	{
-		//		float tentativeGScore = curNode.gCost + (curNode - neighbour);
-
-		//		if (tentativeGScore < neighbour.gCost)
-		//		{
-		//			neighbour.parent = curNode;
-		//			neighbour.gCost = tentativeGScore;
-		//			neighbour.hCost = (neighbour - goalNode);
-
-		//			if (!openList.Contains(neighbour))
-		//			{
-		//				openList.Add(neighbour);
-		//			}
-		//		}
-		//	}
-		//}
-		//return null;
-
-		FIntPoint StartPoint = GetClosestRoomEdge(*Link.RoomA, *Link.RoomB);
-		FIntPoint EndPoint = GetClosestRoomEdge(*Link.RoomB, *Link.RoomA);
-		FPathCell& StartNode = PathGrid[StartPoint.X][StartPoint.Y];
-		FPathCell& EndNode = PathGrid[EndPoint.X][EndPoint.Y];
-		StartNode.hCost = Distance(StartPoint, EndPoint);
-		StartNode.gCost = 0;
-		TArray<FPathCell*> OpenList;
-		OpenList.Add(&StartNode);
-		int32 Attempts = 0;
-		if (StartNode.GridPos == EndNode.GridPos)
-		{
-			return;
-		}
-		while (OpenList.Num() > 0)
-		{
-			FPathCell* CurNode = GetLowestCostCell(OpenList);
-			FPathCell* ParentNode = CurNode->Parent;
-			if (CurNode->GridPos == EndNode.GridPos)
-			{
-				Link.Path = ConstructPath(EndNode);
-				return;
-			}
+// Finds the shortest path between two rooms
+void AMazeGenerator::PopulateLinkPath(FLinkData& Link, const Grid& PathGrid, const FJumpDistances& JumpDistances, FPathSearchState& Search) const
+{
+	FIntPoint StartPoint = GetClosestRoomEdge(*Link.RoomA, *Link.RoomB);
+	FIntPoint EndPoint = GetClosestRoomEdge(*Link.RoomB, *Link.RoomA);
+	if (!IsValidPoint(StartPoint, PathGrid) || !IsValidPoint(EndPoint, PathGrid))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Link between rooms %d and %d leaves the grid."), Link.RoomA->Id, Link.RoomB->Id);
+		return;
+	}
 
-			OpenList.Remove(CurNode);
-			
-			for (FPathCell* Node : GetNeighbours(*CurNode, PathGrid))
-			{
-				float TentativeGScore = CurNode->gCost + Distance(CurNode->GridPos, Node->GridPos);
+	if (StartPoint == EndPoint)
+	{
+		return;
+	}
 
-				if (TentativeGScore < Node->gCost)
-				{
-					Node->Parent = CurNode;
-					Node->gCost = TentativeGScore;
-					Node->hCost = Distance(EndNode.GridPos, Node->GridPos);
+	if (CorridorSearchMode == ECorridorSearchMode::JumpPoint)
+	{
+		Link.Path = ExpandJumpPoints(FindPath(PathGrid, Search, StartPoint, EndPoint, [&PathGrid, &Search, &JumpDistances, EndPoint](int32 Cell, auto&& Visit) {
+			ForEachJumpPoint(Cell, EndPoint, PathGrid, Search, JumpDistances, Visit);
+		}));
+	}
+	else
+	{
+		Link.Path = FindPath(PathGrid, Search, StartPoint, EndPoint, [&PathGrid](int32 Cell, auto&& Visit) {
+			ForEachNeighbour(PathGrid.GetGridPos(Cell), PathGrid, Visit);
+		});
+	}
 
-					if (!OpenList.Contains(Node))
-					{
-						OpenList.Add(Node);
-					}
+	if (Link.Path.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to find path."));
+	}
+}
+
+#pragma endregion
+
+#if !UE_BUILD_SHIPPING
+
+// Cost of a path of neighbouring cells, or INDEX_NONE if it steps anywhere it can't
+static int32 GetPathCost(const Grid& PathGrid, const TArray<FIntPoint>& Path)
+{
+	int32 Cost = 0;
+	for (int32 i = 1; i < Path.Num(); i++)
+	{
+		const FIntPoint Step = Path[i] - Path[i - 1];
+		if (FMath::Abs(Step.X) > 1 || FMath::Abs(Step.Y) > 1 || Step == FIntPoint::ZeroValue) return INDEX_NONE;
+		if (!IsWalkablePoint(Path[i], PathGrid)) return INDEX_NONE;
+
+		Cost += IsDiagonal(Step) ? FPathSearchState::DIAGONAL_COST : FPathSearchState::STRAIGHT_COST;
+	}
+	return Cost;
+}
+
+// Routes the same links across a grid scattered with rectangular walls with A* and with jump point search, checking
+// that both find paths of the same cost. Usage: Ascent.Maze.BenchmarkCorridors [GridSize] [NumWalls] [NumLinks]
+static FAutoConsoleCommand BenchmarkCorridorsCommand(
+	TEXT("Ascent.Maze.BenchmarkCorridors")
+	, TEXT("Compares A* and jump point search corridor routing.")
+	, FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 GridSize = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 512;
+		const int32 NumWalls = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 300;
+		const int32 NumLinks = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 500;
+		if (GridSize <= 1) return;
+
+		FRandomStream Random(GridSize);
+		Grid PathGrid(GridSize, GridSize, true);
+		for (int32 Wall = 0; Wall < NumWalls; Wall++)
+		{
+			const FIntPoint Min(Random.RandRange(0, GridSize - 1), Random.RandRange(0, GridSize - 1));
+			const FIntPoint Max(FMath::Min(GridSize, Min.X + Random.RandRange(1, 40)), FMath::Min(GridSize, Min.Y + Random.RandRange(1, 40)));
+			for (int32 X = Min.X; X < Max.X; X++)
+			{
+				for (int32 Y = Min.Y; Y < Max.Y; Y++)
+				{
+					PathGrid.SetWalkable(PathGrid.GetIndex(FIntPoint(X, Y)), false);
 				}
 			}
+		}
 
-			Attempts++;
-			if (Attempts > 10000000)
+		TArray<TPair<FIntPoint, FIntPoint>> Links;
+		for (int32 Tries = 0; Links.Num() < NumLinks && Tries < NumLinks * 100; Tries++)
+		{
+			const FIntPoint Start(Random.RandRange(0, GridSize - 1), Random.RandRange(0, GridSize - 1));
+			const FIntPoint End(Random.RandRange(0, GridSize - 1), Random.RandRange(0, GridSize - 1));
+			if (Start != End && IsWalkablePoint(Start, PathGrid) && IsWalkablePoint(End, PathGrid))
 			{
-				UE_LOG(LogTemp, Error, TEXT("Failed to find path."))
-					//break;
+				Links.Add(TPair<FIntPoint, FIntPoint>(Start, End));
 			}
-			
-	}
+		}
 
-}
+		double StartTime = FPlatformTime::Seconds();
+		FJumpDistances JumpDistances;
+		BuildJumpDistances(PathGrid, JumpDistances);
+		const double BuildTime = FPlatformTime::Seconds() - StartTime;
+
+		FPathSearchState Search(PathGrid.Num());
+		int64 AStarExpansions = 0;
+		int64 JumpPointExpansions = 0;
+		double AStarTime = 0.0;
+		double JumpPointTime = 0.0;
+		int32 NumMismatches = 0;
+		for (const auto& Link : Links)
+		{
+			const FIntPoint EndPoint = Link.Value;
+
+			StartTime = FPlatformTime::Seconds();
+			const TArray<FIntPoint> AStarPath = FindPath(PathGrid, Search, Link.Key, EndPoint, [&PathGrid, &AStarExpansions](int32 Cell, auto&& Visit) {
+				AStarExpansions++;
+				ForEachNeighbour(PathGrid.GetGridPos(Cell), PathGrid, Visit);
+			});
+			AStarTime += FPlatformTime::Seconds() - StartTime;
+
+			StartTime = FPlatformTime::Seconds();
+			const TArray<FIntPoint> JumpPointPath = ExpandJumpPoints(FindPath(PathGrid, Search, Link.Key, EndPoint, [&PathGrid, &Search, &JumpDistances, &JumpPointExpansions, EndPoint](int32 Cell, auto&& Visit) {
+				JumpPointExpansions++;
+				ForEachJumpPoint(Cell, EndPoint, PathGrid, Search, JumpDistances, Visit);
+			}));
+			JumpPointTime += FPlatformTime::Seconds() - StartTime;
+
+			const int32 AStarCost = AStarPath.Num() > 0 ? GetPathCost(PathGrid, AStarPath) : INDEX_NONE;
+			const int32 JumpPointCost = JumpPointPath.Num() > 0 ? GetPathCost(PathGrid, JumpPointPath) : INDEX_NONE;
+			if (AStarCost != JumpPointCost || (JumpPointPath.Num() > 0 && (JumpPointPath[0] != Link.Key || JumpPointPath.Last() != EndPoint)))
+			{
+				NumMismatches++;
+				UE_LOG(LogTemp, Error, TEXT("  (%d, %d) -> (%d, %d): A* cost %d, jump point cost %d"), Link.Key.X, Link.Key.Y, EndPoint.X, EndPoint.Y, AStarCost, JumpPointCost);
+			}
+		}
+
+		const int32 NumSearches = FMath::Max(Links.Num(), 1);
+		UE_LOG(LogTemp, Display, TEXT("Corridors, %d x %d grid, %d walls, %d links"), GridSize, GridSize, NumWalls, Links.Num());
+		UE_LOG(LogTemp, Display, TEXT("  Jump distances: %.3f ms"), BuildTime * 1000.0);
+		UE_LOG(LogTemp, Display, TEXT("  A*: %.3f ms/search, %lld expansions/search"), AStarTime * 1000.0 / NumSearches, AStarExpansions / NumSearches);
+		UE_LOG(LogTemp, Display, TEXT("  Jump point: %.3f ms/search, %lld expansions/search, %.2fx"), JumpPointTime * 1000.0 / NumSearches, JumpPointExpansions / NumSearches, AStarTime / FMath::Max(JumpPointTime, 1e-9));
+		if (NumMismatches > 0)
+		{
+			UE_LOG(LogTemp, Error, TEXT("  %d of %d paths differ in cost"), NumMismatches, Links.Num());
+		}
+	})
+);
 
-#pragma endregion	
+#endif
@@ -144,6 +144,11 @@ struct FDTriangle {
 
 	FDEdge E3;
 
+	// Cached at construction so the in-circle test is a single squared distance comparison
+	FVector2D CircumCenter;
+
+	float CircumRadiusSqr;
+
 	// Initialize
 	FDTriangle(const FDPoint& InP1, const FDPoint& InP2, const FDPoint& InP3)
 		: P1(InP1)
@@ -152,7 +157,15 @@ struct FDTriangle {
 		, E1(FDEdge(InP1, InP2))
 		, E2(FDEdge(InP2, InP3))
 		, E3(FDEdge(InP3, InP1))
-	{}
+	{
+		float D = (P1.X * (P2.Y - P3.Y) + P2.X * (P3.Y - P1.Y) + P3.X * (P1.Y - P2.Y)) * 2;
+		float X = ((P1.X * P1.X + P1.Y * P1.Y) * (P2.Y - P3.Y) + (P2.X * P2.X + P2.Y * P2.Y) * (P3.Y - P1.Y) + (P3.X * P3.X + P3.Y * P3.Y) * (P1.Y - P2.Y));
+		float Y = ((P1.X * P1.X + P1.Y * P1.Y) * (P3.X - P2.X) + (P2.X * P2.X + P2.Y * P2.Y) * (P1.X - P3.X) + (P3.X * P3.X + P3.Y * P3.Y) * (P2.X - P1.X));
+
+		// Degenerate triangles keep an empty circle at the origin
+		CircumCenter = (D != 0.f ? FVector2D(X / D, Y / D) : FVector2D(0.f, 0.f));
+		CircumRadiusSqr = (D != 0.f ? P1.GetDistSqr(CircumCenter) : 0.f);
+	}
 
 	// Functions
 
@@ -197,24 +210,11 @@ struct FDTriangle {
 	}
 
 	float GetCircumRadius() const {
-		FVector SidesLength = GetSidesLength();
-		float Cross = QuatCross(SidesLength.X, SidesLength.Y, SidesLength.Z);
-		// Safe division
-		return (Cross != 0.f ? (SidesLength.X * SidesLength.Y * SidesLength.Z) / Cross : 0.f);
+		return FMath::Sqrt(CircumRadiusSqr);
 	}
 
 	FVector2D GetCircumCenter() const {
-		//FVector2D ME1 = E1.GetMidPoint();
-		//FVector2D ME2 = E2.GetMidPoint();
-		//float SE1 = E1.GetSlope();
-		//float SE2 = E2.GetSlope();
-		//float PE1 = E1.GetSlopePerpendicular();
-		//float PE2 = E2.GetSlopePerpendicular();
-		float D = (P1.X * (P2.Y - P3.Y) + P2.X * (P3.Y - P1.Y) + P3.X * (P1.Y - P2.Y)) * 2;
-		float X = ((P1.X * P1.X + P1.Y * P1.Y) * (P2.Y - P3.Y) + (P2.X * P2.X + P2.Y * P2.Y) * (P3.Y - P1.Y) + (P3.X * P3.X + P3.Y * P3.Y) * (P1.Y - P2.Y));
-		float Y = ((P1.X * P1.X + P1.Y * P1.Y) * (P3.X - P2.X) + (P2.X * P2.X + P2.Y * P2.Y) * (P1.X - P3.X) + (P3.X * P3.X + P3.Y * P3.Y) * (P2.X - P1.X));
-
-		return (D != 0.f ? FVector2D(X / D, Y / D) : FVector2D(0.f, 0.f));
+		return CircumCenter;
 	}
 
 	float GetArea() const {
@@ -223,10 +223,9 @@ struct FDTriangle {
 	}
 
 	bool IsInCircumCircle(const FDPoint& InPoint) const {
-		FVector2D Center = GetCircumCenter();
-		return (FMath::Square(Center.X - InPoint.X)
-			+ FMath::Square(Center.Y - InPoint.Y)
-			<= FMath::Square(GetCircumRadius())
+		return (FMath::Square(CircumCenter.X - InPoint.X)
+			+ FMath::Square(CircumCenter.Y - InPoint.Y)
+			<= CircumRadiusSqr
 			);
 	}
 
@@ -251,6 +250,275 @@ public:
 };
 
 
+// Compact triangulation output. Vertex I is point I of the triangulated array, and triangles and edges only
+// refer to vertices by index. Half-edge E belongs to triangle E / 3 and runs from Triangles[E] to Triangles[NextHalfEdge(E)].
+struct FDMesh {
+
+	TArray<float> X;
+
+	TArray<float> Y;
+
+	// Three vertex indices per triangle, counter-clockwise
+	TArray<int32> Triangles;
+
+	// The opposite half-edge of each half-edge, INDEX_NONE on the hull
+	TArray<int32> HalfEdges;
+
+	// One outgoing half-edge per vertex, the hull edge for vertices on the hull. INDEX_NONE if the vertex isn't in the mesh.
+	TArray<int32> VertexHalfEdges;
+
+	// Functions
+
+	static int32 NextHalfEdge(int32 E) {
+		return (E % 3 == 2) ? E - 2 : E + 1;
+	}
+
+	static int32 PrevHalfEdge(int32 E) {
+		return (E % 3 == 0) ? E + 2 : E - 1;
+	}
+
+	int32 GetNumVertices() const {
+		return X.Num();
+	}
+
+	int32 GetNumTriangles() const {
+		return Triangles.Num() / 3;
+	}
+
+	int32 GetEdgeStart(int32 E) const {
+		return Triangles[E];
+	}
+
+	int32 GetEdgeEnd(int32 E) const {
+		return Triangles[NextHalfEdge(E)];
+	}
+
+	float GetEdgeLengthSqr(int32 E) const {
+		return FMath::Square(X[GetEdgeEnd(E)] - X[GetEdgeStart(E)]) + FMath::Square(Y[GetEdgeEnd(E)] - Y[GetEdgeStart(E)]);
+	}
+
+	FDPoint GetPoint(int32 Vertex) const {
+		return FDPoint(X[Vertex], Y[Vertex], Vertex);
+	}
+
+	FDTriangle GetTriangle(int32 Triangle) const {
+		return FDTriangle(GetPoint(Triangles[Triangle * 3]), GetPoint(Triangles[Triangle * 3 + 1]), GetPoint(Triangles[Triangle * 3 + 2]));
+	}
+
+	// Calls Func(E) once for every undirected edge
+	template<typename FuncType>
+	void ForEachEdge(FuncType Func) const {
+		for (int32 E = 0; E < HalfEdges.Num(); E++) {
+			if (HalfEdges[E] == INDEX_NONE || E < HalfEdges[E]) {
+				Func(E);
+			}
+		}
+	}
+
+	// Calls Func(Neighbour) for every vertex connected to Vertex, counter-clockwise
+	template<typename FuncType>
+	void ForEachNeighbour(int32 Vertex, FuncType Func) const {
+		const int32 Start = VertexHalfEdges[Vertex];
+		if (Start == INDEX_NONE) return;
+
+		int32 E = Start;
+		do {
+			Func(GetEdgeEnd(E));
+			const int32 Incoming = PrevHalfEdge(E);
+			E = HalfEdges[Incoming];
+			if (E == INDEX_NONE) {
+				// Reached the hull, the incoming edge's start is the last neighbour
+				Func(GetEdgeStart(Incoming));
+				return;
+			}
+		} while (E != Start);
+	}
+};
+
+
+// Edges added and removed by one edit of a triangulation, as vertex pairs with the smaller index in X
+struct FDEdgeChanges {
+
+	TArray<FIntPoint> Added;
+
+	TArray<FIntPoint> Removed;
+
+	// Functions
+
+	void Reset() {
+		Added.Reset();
+		Removed.Reset();
+	}
+
+	static FIntPoint MakeEdge(int32 V1, int32 V2) {
+		return FIntPoint(FMath::Min(V1, V2), FMath::Max(V1, V2));
+	}
+};
+
+
+// Incremental Delaunay triangulation. Each vertex is located by walking across the mesh from a nearby triangle,
+// then every triangle whose circumcircle contains it (the cavity) is replaced by a fan of triangles around the vertex.
+// The first three vertices are a super triangle that encloses every point. The triangulation can be kept around
+// and edited point by point, each edit only repairing the triangles around the point.
+class FDTriangulation {
+
+public:
+
+	// Vertex positions, stored once
+	TArray<double> X;
+
+	TArray<double> Y;
+
+	// Three vertex indices per triangle, counter-clockwise. Half-edge E belongs to triangle E / 3 and runs from
+	// Triangles[E] to Triangles[NextHalfEdge(E)]. Removed triangles are marked with INDEX_NONE.
+	TArray<int32> Triangles;
+
+	// The opposite half-edge of each half-edge, INDEX_NONE on the outside of the super triangle
+	TArray<int32> HalfEdges;
+
+	// Circumcircle of each triangle, computed once when the triangle is made
+	TArray<double> CircumX;
+
+	TArray<double> CircumY;
+
+	TArray<double> CircumRadiusSqr;
+
+	// One outgoing half-edge per vertex, INDEX_NONE once a vertex has been removed or if it was never inserted
+	TArray<int32> VertexHalfEdges;
+
+	static const int32 NumSuperVertices = 3;
+
+	// Functions
+
+	static int32 NextHalfEdge(int32 E) {
+		return (E % 3 == 2) ? E - 2 : E + 1;
+	}
+
+	static int32 PrevHalfEdge(int32 E) {
+		return (E % 3 == 0) ? E + 2 : E - 1;
+	}
+
+	static bool IsSuperVertex(int32 Vertex) {
+		return Vertex < NumSuperVertices;
+	}
+
+	bool IsTriangleAlive(int32 Triangle) const {
+		return Triangles[Triangle * 3] != INDEX_NONE;
+	}
+
+	int32 GetNumTriangleSlots() const {
+		return Triangles.Num() / 3;
+	}
+
+	// Clears the mesh and adds a super triangle around the given bounds. ConvexMultiplier scales the super triangle,
+	// small values carve concave hulls while large values get closer to the convex hull.
+	void Reset(double MinX, double MinY, double MaxX, double MaxY, int32 ConvexMultiplier, int32 ExpectedVertices = 0);
+
+	// Adds a vertex without inserting it into the mesh. Returns its index.
+	int32 AddVertex(double InX, double InY);
+
+	// Inserts an added vertex into the mesh. Returns false if it duplicates an existing vertex.
+	bool InsertVertex(int32 Vertex, FDEdgeChanges* OutChanges = nullptr);
+
+	// Adds and inserts a single point. Returns its vertex index, or INDEX_NONE if it duplicates an existing vertex.
+	int32 InsertPoint(double InX, double InY, FDEdgeChanges* OutChanges = nullptr);
+
+	// Takes a vertex out of the mesh and retriangulates the hole it leaves. Super vertices can't be removed.
+	bool RemoveVertex(int32 Vertex, FDEdgeChanges* OutChanges = nullptr);
+
+	// Adds and inserts every point, in an order that keeps consecutive points close together.
+	void InsertPoints(const TArray<FDPoint>& InPoints);
+
+	// Returns the triangle containing the position, or INDEX_NONE if it is outside the super triangle. The walk starts
+	// from StartTriangle when given, otherwise from the last triangle made.
+	int32 Locate(double InX, double InY, int32 StartTriangle = INDEX_NONE) const;
+
+	// Tests a position against a packed block of at most 64 circumcircles. Bit I of the result is set when the
+	// position is strictly inside circle I. Uses vector registers where the platform has them.
+	static uint64 FindContainingCircles(const double* InCircumX, const double* InCircumY, const double* InRadiusSqr, int32 Num, double InX, double InY);
+
+	// Reference version of FindContainingCircles, one circle at a time
+	static uint64 FindContainingCirclesScalar(const double* InCircumX, const double* InCircumY, const double* InRadiusSqr, int32 Num, double InX, double InY);
+
+	// Copies the triangles that don't touch the super triangle into a compact mesh. Vertex I of the mesh is the
+	// vertex added after the super triangle, and twins across removed triangles become hull edges.
+	void BuildMesh(FDMesh& OutMesh) const;
+
+private:
+
+	int32 AddTriangle(int32 V1, int32 V2, int32 V3);
+
+	double Orient(int32 V1, int32 V2, double InX, double InY) const;
+
+	// Whether a position is inside the circle through three vertices, for a triangle that doesn't exist yet
+	bool IsInCircle(int32 V1, int32 V2, int32 V3, double InX, double InY) const;
+
+	void LinkHalfEdges(int32 E, int32 Twin);
+
+	// A triangle near the position to start Locate from, INDEX_NONE if there is none
+	int32 GetLocateHint(double InX, double InY) const;
+
+	int32 GetLocateCell(double InX, double InY) const;
+
+	struct FBoundaryEdge {
+
+		int32 V1;
+
+		int32 V2;
+
+		int32 Twin;
+	};
+
+	int32 LastTriangle = INDEX_NONE;
+
+	// Insertion stamps per triangle, so the cavity search never needs clearing
+	TArray<uint32> Marks;
+
+	uint32 Stamp = 0;
+
+	TArray<int32> FreeTriangles;
+
+	TArray<int32> Cavity;
+
+	// Circumcircles of the triangles next to the cavity, packed for FindContainingCircles
+	TArray<int32> Candidates;
+
+	TArray<double> CandidateX;
+
+	TArray<double> CandidateY;
+
+	TArray<double> CandidateRadiusSqr;
+
+	TArray<FBoundaryEdge> Boundary;
+
+	// The new triangle made for each boundary edge
+	TArray<int32> Fan;
+
+	// Open-addressing table from a fan triangle's first vertex to the triangle, sized to a power of two
+	TArray<int32> FanKeys;
+
+	TArray<int32> FanTriangles;
+
+	// Coarse grid over the bounds given to Reset, holding a recently inserted vertex per cell
+	TArray<int32> LocateGrid;
+
+	int32 LocateGridSize = 0;
+
+	double LocateGridMinX = 0.0;
+
+	double LocateGridMinY = 0.0;
+
+	double LocateGridCellSize = 1.0;
+
+	// The hole left by a removed vertex, counter-clockwise, with the twin of each hole edge outside it
+	TArray<int32> Ring;
+
+	TArray<int32> RingTwins;
+
+	TArray<int32> RingVertices;
+};
+
+
 class FDelaunay {
 
 private:
@@ -270,4 +538,12 @@ public:
 
 	TArray<FDTriangle> Triangulate(TArray<FDPoint>& InPoints, int32 InDelaunayConvexMultiplier) const;
 
+	FDMesh TriangulateMesh(TArray<FDPoint>& InPoints, int32 InDelaunayConvexMultiplier) const;
+
+	// Splits the points into vertical strips triangulated concurrently, then merges the seams. Gives the same
+	// triangles as TriangulateMesh for points in general position. Where four or more points share a circle, as
+	// they often do on a lattice, the result is still a Delaunay triangulation but may split the polygon they form
+	// with different diagonals. InNumStrips defaults to one per worker thread.
+	FDMesh TriangulateMeshParallel(TArray<FDPoint>& InPoints, int32 InDelaunayConvexMultiplier, int32 InNumStrips = 0) const;
+
 };
\ No newline at end of file
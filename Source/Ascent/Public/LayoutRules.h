@@ -56,6 +56,17 @@ enum class ERoomType : uint8
 	Corridor UMETA(DisplayName = "Corridor")
 };
 
+constexpr int32 NUM_ROOM_TYPES = (int32)ERoomType::Corridor + 1;
+
+// Set of room types with one bit per ERoomType
+typedef uint8 FRoomTypeMask;
+static_assert(NUM_ROOM_TYPES <= sizeof(FRoomTypeMask) * 8, "FRoomTypeMask needs a bit for every room type");
+
+FORCEINLINE FRoomTypeMask ToRoomTypeMask(ERoomType RoomType)
+{
+	return (FRoomTypeMask)(1 << (uint8)RoomType);
+}
+
 USTRUCT(BlueprintType)
 struct FEntropyData
 {
@@ -72,21 +83,6 @@ struct FLayoutRules
 	GENERATED_BODY()
 	
 public:
-	FLayoutRules()
-	{
-		// Normalise weights
-		float Sum = 0;
-		for (auto& RoomTypeWeight : RoomTypeWeights)
-		{
-			Sum += RoomTypeWeight.Value;
-		}
-
-		for (auto& RoomTypeWeight : RoomTypeWeights)
-		{
-			RoomTypeWeight.Value /= Sum;
-		}
-	}
-
 	UPROPERTY(EditAnywhere)
 		TMap<ERoomType, FEntropyData> RoomEntropy;
 
@@ -100,3 +96,50 @@ public:
 		TMap<ERoomType, float> RoomTypeWeights;
 
 };
+
+// Weighted roll over the room types of one domain as a Vose alias table. Each slot keeps its own room type with
+// some probability and hands the rest to its alias, so a roll costs one draw whatever the weights are.
+struct FRoomTypeDistribution
+{
+public:
+	int32 Num;
+	ERoomType RoomTypes[NUM_ROOM_TYPES];
+	float Probabilities[NUM_ROOM_TYPES];
+	uint8 Aliases[NUM_ROOM_TYPES];
+
+	// Builds the table over the room types in Domain. Domains without any weight roll uniformly.
+	void Build(FRoomTypeMask Domain, const float (&Weights)[NUM_ROOM_TYPES]);
+
+	ERoomType Sample(const FRandomStream& Random) const
+	{
+		checkSlow(Num > 0);
+
+		// The whole part of the roll picks the slot and the fraction decides between it and its alias
+		const float Roll = Random.GetFraction() * Num;
+		const int32 Slot = FMath::Min((int32)Roll, Num - 1);
+		return Roll - Slot < Probabilities[Slot] ? RoomTypes[Slot] : RoomTypes[Aliases[Slot]];
+	}
+};
+
+// FLayoutRules baked into dense arrays indexed by room type, and tables indexed by domain, so generation never looks
+// anything up in a map
+struct ASCENT_API FCompiledLayoutRules
+{
+public:
+	FCompiledLayoutRules();
+	explicit FCompiledLayoutRules(const FLayoutRules& Rules);
+
+	// Weights normalised to sum to one
+	float Weights[NUM_ROOM_TYPES];
+	F2DRange RoomSizes[NUM_ROOM_TYPES];
+	TSubclassOf<URoom> RoomBPs[NUM_ROOM_TYPES];
+
+	// Largest room size of any room type on each axis
+	FIntPoint MaxRoomSize;
+
+	// For each domain, the room types its neighbours may still be, its Shannon entropy, and the distribution a tile
+	// with that domain collapses from
+	FRoomTypeMask CompatibleRoomTypes[1 << NUM_ROOM_TYPES];
+	float DomainEntropies[1 << NUM_ROOM_TYPES];
+	FRoomTypeDistribution DomainDistributions[1 << NUM_ROOM_TYPES];
+};
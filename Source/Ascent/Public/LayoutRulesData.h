@@ -18,4 +18,19 @@ class ASCENT_API ULayoutRulesData : public UPrimaryDataAsset
 	public:
 		UPROPERTY(EditDefaultsOnly)
 			FLayoutRules LayoutRules;
+
+		virtual void PostLoad() override;
+
+#if WITH_EDITOR
+		virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+		const FCompiledLayoutRules& GetCompiledRules() const
+		{
+			return CompiledRules;
+		}
+
+	private:
+		// Rebuilt whenever LayoutRules is loaded or edited
+		FCompiledLayoutRules CompiledRules;
 };
@@ -5,36 +5,27 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include <LayoutRules.h>
+#include "LayoutRulesData.h"
 #include "Delauney.h"
+#include <atomic>
 #include "MazeGenerator.generated.h"
 
-struct FPathCell
+UENUM()
+enum class ERoomSizingMode : uint8
 {
-public:
-	FPathCell() 
-	{
-		IsWalkable = true;
-		gCost = INFINITY;
-	}
-
-	FPathCell(FIntPoint InGridPos, bool InIsWalkable)
-	{
-		GridPos = InGridPos;
-		IsWalkable = InIsWalkable;
-		gCost = INFINITY;
-		Parent = nullptr;
-	}
-
-	FIntPoint GridPos;
-	bool IsWalkable;
-	double hCost;
-	double gCost;
-	FPathCell* Parent;
+	// Push overlapping rooms apart over several passes, which can give up with rooms still overlapping
+	PushApart UMETA(DisplayName = "Push Apart"),
+	// Place rooms one at a time at the nearest spot clear of the rooms already placed, in a single pass
+	Packed UMETA(DisplayName = "Packed"),
+};
 
-	double fCost()
-	{
-		return hCost + gCost;
-	}
+UENUM()
+enum class ECorridorSearchMode : uint8
+{
+	// A* over every neighbouring cell
+	AStar UMETA(DisplayName = "A*"),
+	// Jump point search, which finds paths as short as A*'s while only expanding cells where a path could turn
+	JumpPoint UMETA(DisplayName = "Jump Point Search"),
 };
 
 class FRoomData;
@@ -80,7 +71,6 @@ public:
 	FVector Position;
 	F2DRange Corners;
 	int32 Id;
-	TArray<FRoomData*> Neighbours;
 
 	friend FORCEINLINE uint32 GetTypeHash(const FRoomData& s)
 	{
@@ -103,109 +93,565 @@ public:
 	}
 };
 
+// Undirected graph over room indices in compressed sparse row form. Room i's neighbours are stored contiguously
+// in Neighbours[Offsets[i]] up to Neighbours[Offsets[i + 1]], and every edge is stored from both ends.
+struct FRoomGraph
+{
+public:
+	TArray<int32> Offsets;
+	TArray<int32> Neighbours;
+
+	void Build(int32 NumRooms, const TArray<FIntPoint>& Edges)
+	{
+		// Count each room's degree, turn the counts into row ends, then fill each row backwards so the ends become starts
+		Offsets.Init(0, NumRooms + 1);
+		for (const FIntPoint& Edge : Edges)
+		{
+			Offsets[Edge.X]++;
+			Offsets[Edge.Y]++;
+		}
+		for (int32 Room = 1; Room <= NumRooms; Room++)
+		{
+			Offsets[Room] += Offsets[Room - 1];
+		}
+
+		Neighbours.SetNumUninitialized(Offsets[NumRooms]);
+		for (const FIntPoint& Edge : Edges)
+		{
+			Neighbours[--Offsets[Edge.X]] = Edge.Y;
+			Neighbours[--Offsets[Edge.Y]] = Edge.X;
+		}
+	}
+
+	int32 Num() const
+	{
+		return FMath::Max(Offsets.Num() - 1, 0);
+	}
+
+	TArrayView<const int32> GetNeighbours(int32 Room) const
+	{
+		return TArrayView<const int32>(Neighbours.GetData() + Offsets[Room], Offsets[Room + 1] - Offsets[Room]);
+	}
+
+	// Removes every edge the predicate returns true for, compacting the rows in place. The predicate is given both
+	// directions of each edge and must treat them the same.
+	template <typename PredicateType>
+	void RemoveEdges(PredicateType Predicate)
+	{
+		int32 WriteIndex = 0;
+		int32 RowStart = 0;
+		for (int32 Room = 0; Room < Num(); Room++)
+		{
+			const int32 RowEnd = Offsets[Room + 1];
+			for (int32 i = RowStart; i < RowEnd; i++)
+			{
+				if (!Predicate(Room, Neighbours[i]))
+				{
+					Neighbours[WriteIndex++] = Neighbours[i];
+				}
+			}
+			RowStart = RowEnd;
+			Offsets[Room + 1] = WriteIndex;
+		}
+		Neighbours.SetNum(WriteIndex, false);
+	}
+
+	bool IsConnected() const
+	{
+		if (Num() == 0) return true;
+
+		TArray<int32> Stack;
+		TArray<bool> Visited;
+		Visited.Init(false, Num());
+
+		Stack.Add(0);
+		Visited[0] = true;
+		int32 NumVisited = 1;
+
+		while (Stack.Num() > 0)
+		{
+			const int32 Current = Stack.Pop(false);
+			for (const int32 Neighbour : GetNeighbours(Current))
+			{
+				if (!Visited[Neighbour])
+				{
+					Visited[Neighbour] = true;
+					NumVisited++;
+					Stack.Add(Neighbour);
+				}
+			}
+		}
+
+		return NumVisited == Num();
+	}
+};
+
+// A room during room typing. Its domain is the set of room types it can still become, so tiles are plain data
+// and narrowing a domain is a single AND.
 class FRoomTile
 {
 public:
 	int32 Id;
-	TArray<FRoomTile*> Neighbours;
-	TArray<ERoomType> PossibleRoomTypes;
+	FRoomTypeMask Domain;
 	float Entropy;
 	bool bCollapsed;
+	bool bQueued;
 	FIntPoint GridPos;
-	FLayoutRules* LayoutRules;
 
 	FRoomTile() { }
 
-	FRoomTile(int32 Id, FIntPoint GridPos, FLayoutRules* InLayoutRules)
+	FRoomTile(int32 Id, FIntPoint GridPos)
 	{
 		this->Id = Id;
-		this->LayoutRules = InLayoutRules;
 		this->GridPos = GridPos;
 		Entropy = 0;
-		PossibleRoomTypes.Add(ERoomType::Treasure);
-		PossibleRoomTypes.Add(ERoomType::Boss);
-		PossibleRoomTypes.Add(ERoomType::Normal);
-		PossibleRoomTypes.Add(ERoomType::AscentPoint);
-		PossibleRoomTypes.Add(ERoomType::Spawn);
+		Domain = ToRoomTypeMask(ERoomType::Treasure)
+			| ToRoomTypeMask(ERoomType::Boss)
+			| ToRoomTypeMask(ERoomType::Normal)
+			| ToRoomTypeMask(ERoomType::AscentPoint)
+			| ToRoomTypeMask(ERoomType::Spawn);
 
 		bCollapsed = false;
-
-		// WFC requires the room types to be sorted by their weights in decending order
-		PossibleRoomTypes.Sort([InLayoutRules](const ERoomType& A, const ERoomType& B) {
-			return InLayoutRules->RoomTypeWeights.FindRef(A) > InLayoutRules->RoomTypeWeights.FindRef(B);
-		});
+		bQueued = false;
 	}
 
 	void Collapse(ERoomType RoomType)
 	{
 		bCollapsed = true;
-		PossibleRoomTypes = TArray<ERoomType> { RoomType };
+		Domain = ToRoomTypeMask(RoomType);
 	}
 
-	void RecalculateEntropy()
+	int32 GetNumPossibleRoomTypes() const
 	{
-		float Sum = 0;
-		float LogSum = 0;
-		for (ERoomType RoomType : PossibleRoomTypes)
+		return FMath::CountBits(Domain);
+	}
+
+	bool CanBe(ERoomType RoomType) const
+	{
+		return (Domain & ToRoomTypeMask(RoomType)) != 0;
+	}
+
+	// The lowest room type left in the domain, which is the only one once the tile has collapsed
+	ERoomType GetRoomType() const
+	{
+		return (ERoomType)FMath::CountTrailingZeros((uint32)Domain);
+	}
+};
+
+// Indexed binary min-heap of tiles keyed by entropy. Each tile's position in the heap is tracked, so a queued tile
+// can have its entropy changed or be removed in O(log n) without searching for it. Ties go to the lower tile index,
+// so the order tiles come out in doesn't depend on the order they went in.
+class FEntropyQueue
+{
+public:
+
+	void Reset(int32 NumTiles)
+	{
+		Heap.Reset(NumTiles);
+		Entropies.SetNumUninitialized(NumTiles);
+		Positions.Init(INDEX_NONE, NumTiles);
+	}
+
+	bool IsEmpty() const
+	{
+		return Heap.Num() == 0;
+	}
+
+	void Push(int32 Tile, float Entropy)
+	{
+		Entropies[Tile] = Entropy;
+		SiftUp(Heap.Add(Tile));
+	}
+
+	// Changes a queued tile's entropy. Tiles that aren't queued are left alone and false is returned.
+	bool Update(int32 Tile, float Entropy)
+	{
+		if (Positions[Tile] == INDEX_NONE) return false;
+
+		Entropies[Tile] = Entropy;
+		SiftUp(Positions[Tile]);
+		SiftDown(Positions[Tile]);
+		return true;
+	}
+
+	// Removes and returns the tile with the lowest entropy, or INDEX_NONE if the queue is empty
+	int32 Pop()
+	{
+		if (Heap.Num() == 0) return INDEX_NONE;
+
+		const int32 Tile = Heap[0];
+		RemoveAt(0);
+		return Tile;
+	}
+
+	bool Remove(int32 Tile)
+	{
+		if (Positions[Tile] == INDEX_NONE) return false;
+
+		RemoveAt(Positions[Tile]);
+		return true;
+	}
+
+private:
+
+	TArray<int32> Heap;
+	TArray<float> Entropies;
+	TArray<int32> Positions;
+
+	bool IsLess(int32 TileA, int32 TileB) const
+	{
+		return Entropies[TileA] < Entropies[TileB] || (Entropies[TileA] == Entropies[TileB] && TileA < TileB);
+	}
+
+	void RemoveAt(int32 Position)
+	{
+		Positions[Heap[Position]] = INDEX_NONE;
+		const int32 Last = Heap.Pop(false);
+		if (Position < Heap.Num())
+		{
+			Heap[Position] = Last;
+			SiftUp(Position);
+			SiftDown(Positions[Last]);
+		}
+	}
+
+	void SiftUp(int32 Position)
+	{
+		const int32 Tile = Heap[Position];
+		while (Position > 0)
+		{
+			const int32 Parent = (Position - 1) / 2;
+			if (!IsLess(Tile, Heap[Parent])) break;
+
+			Heap[Position] = Heap[Parent];
+			Positions[Heap[Position]] = Position;
+			Position = Parent;
+		}
+		Heap[Position] = Tile;
+		Positions[Tile] = Position;
+	}
+
+	void SiftDown(int32 Position)
+	{
+		const int32 Tile = Heap[Position];
+		while (true)
 		{
-			float Weight = LayoutRules->RoomTypeWeights.FindRef(RoomType);
-			Sum += Weight;
-			LogSum += FMath::Log2(Weight) * Weight;
+			int32 Child = Position * 2 + 1;
+			if (Child >= Heap.Num()) break;
+			if (Child + 1 < Heap.Num() && IsLess(Heap[Child + 1], Heap[Child])) Child++;
+			if (!IsLess(Heap[Child], Tile)) break;
+
+			Heap[Position] = Heap[Child];
+			Positions[Heap[Position]] = Position;
+			Position = Child;
 		}
-		Entropy = FMath::Log2(Sum) - (LogSum / Sum);
+		Heap[Position] = Tile;
+		Positions[Tile] = Position;
 	}
 };
 
+// A tile's state before it was changed, so the change can be undone
+struct FRoomTileChange
+{
+public:
+	int32 TileIndex;
+	FRoomTypeMask Domain;
+	bool bCollapsed;
+};
+
+// Working state of room typing. Every change to a tile is recorded in the trail before it is made, so the tiles can be
+// rolled back to any earlier point of the trail instead of being rebuilt.
+struct FRoomTypingState
+{
+public:
+	TArray<FRoomTile> Tiles;
+	FRoomGraph Graph;
+	FEntropyQueue EntropyQueue;
+	TArray<FRoomTileChange> Trail;
+
+	// Each attempt draws from its own stream, so it types the rooms the same way on whichever thread it runs
+	FRandomStream Random;
+	int32 AttemptIndex = 0;
+
+	// Lowest attempt known to have succeeded when attempts run in parallel. Any later attempt can stop early.
+	const std::atomic<int32>* WinningAttempt = nullptr;
+
+	bool IsCancelled() const
+	{
+		return WinningAttempt != nullptr && WinningAttempt->load(std::memory_order_relaxed) < AttemptIndex;
+	}
+};
+
+// Pathfinding grid addressed by cell index. A tiled grid orders cells in 8x8 tiles rather than row by row, so a
+// search's neighbours mostly share cache lines. Searches only read the grid, so any number can run over it at once.
 class Grid
 {
-	typedef FPathCell* iterator;
-	typedef const FPathCell* const_iterator;
-	uint32 Width;
-	uint32 Length;
+public:
+
+	static constexpr int32 TILE_SHIFT = 3;
+	static constexpr int32 TILE_SIZE = 1 << TILE_SHIFT;
+
+	Grid(int32 InLength, int32 InWidth, bool bInTiled = false)
+	{
+		Length = InLength;
+		Width = InWidth;
+		bTiled = bInTiled;
+
+		// Tiled grids are padded out to whole tiles
+		TilesY = (Width + TILE_SIZE - 1) >> TILE_SHIFT;
+		const int32 NumCells = bTiled ? ((Length + TILE_SIZE - 1) >> TILE_SHIFT) * TilesY * TILE_SIZE * TILE_SIZE : Length * Width;
+
+		Walkable.Init(true, NumCells);
+	}
 
-	FPathCell** Arr;
+	int32 GetLength(uint8 Axis) const
+	{
+		return Axis == 0 ? Length : Width;
+	}
+
+	int32 Num() const
+	{
+		return Walkable.Num();
+	}
+
+	int32 GetIndex(FIntPoint GridPos) const
+	{
+		if (!bTiled) return GridPos.X * Width + GridPos.Y;
+
+		const int32 Tile = (GridPos.X >> TILE_SHIFT) * TilesY + (GridPos.Y >> TILE_SHIFT);
+		return (Tile << (TILE_SHIFT * 2)) | ((GridPos.X & (TILE_SIZE - 1)) << TILE_SHIFT) | (GridPos.Y & (TILE_SIZE - 1));
+	}
+
+	FIntPoint GetGridPos(int32 Index) const
+	{
+		if (!bTiled) return FIntPoint(Index / Width, Index % Width);
+
+		const int32 Tile = Index >> (TILE_SHIFT * 2);
+		return FIntPoint(
+			((Tile / TilesY) << TILE_SHIFT) | ((Index >> TILE_SHIFT) & (TILE_SIZE - 1)),
+			((Tile % TilesY) << TILE_SHIFT) | (Index & (TILE_SIZE - 1)));
+	}
+
+	bool IsWalkable(int32 Index) const
+	{
+		return Walkable[Index];
+	}
+
+	void SetWalkable(int32 Index, bool bWalkable)
+	{
+		Walkable[Index] = bWalkable;
+	}
 
+private:
+
+	int32 Length;
+	int32 Width;
+	bool bTiled;
+	int32 TilesY;
+
+	TBitArray<> Walkable;
+};
+
+// Scratch state of a search over a grid, stored as flat planes holding one value per cell and addressed by the
+// grid's cell index. Each thread searching the grid needs its own.
+class FPathSearchState
+{
 public:
 
-	iterator begin() { return Arr[0]; }
-	const_iterator begin() const { return Arr[0]; }
-	iterator end() { return Arr[Width * Length]; }
-	const_iterator end() const { return Arr[Length * Width]; }
+	// Path costs are whole numbers, with 99 / 70 standing in for the square root of two, so costs that are equal add
+	// up to exactly the same value whichever order their steps were taken in
+	static constexpr int32 STRAIGHT_COST = 70;
+	static constexpr int32 DIAGONAL_COST = 99;
+	static constexpr int32 UNREACHED_COST = MAX_int32;
+
+	// Memory a search state takes for each cell of its grid: g cost, parent, open index and stamp, plus the closed bit
+	static constexpr int32 BYTES_PER_CELL = sizeof(int32) * 3 + sizeof(uint32) + 1;
 
-	Grid() {}
+	explicit FPathSearchState(int32 NumCells)
+	{
+		GCosts.Init(UNREACHED_COST, NumCells);
+		Parents.Init(INDEX_NONE, NumCells);
+		OpenIndices.Init(INDEX_NONE, NumCells);
+		Closed.Init(false, NumCells);
+		SearchStamps.Init(0, NumCells);
+		CurrentSearch = 0;
+	}
 
-	Grid(uint32 L, uint32 W)
+	// Starts a new search. Cells are stamped with the search that reached them and anything with an older stamp
+	// reads as unreached, so searches can share the state without clearing it in between.
+	void BeginSearch()
 	{
-		Length = L;
-		Width = W;
-		Arr = new FPathCell*[L];
-		for (uint32 X = 0; X < L; X++)
+		CurrentSearch++;
+		if (CurrentSearch == 0)
 		{
-			Arr[X] = new FPathCell[W];
-			for (uint32 Y = 0; Y < W; Y++)
-			{
-				Arr[X][Y] = FPathCell(FIntPoint(X, Y), true);
-			}
+			// The stamps wrapped, so old ones could pass for new ones
+			SearchStamps.Init(0, SearchStamps.Num());
+			CurrentSearch = 1;
 		}
 	}
 
-	~Grid()
+	bool IsReached(int32 Index) const
+	{
+		return SearchStamps[Index] == CurrentSearch;
+	}
+
+	// Stamps a cell with the current search, clearing whatever an earlier search left in it
+	void Reach(int32 Index)
+	{
+		if (IsReached(Index)) return;
+
+		SearchStamps[Index] = CurrentSearch;
+		GCosts[Index] = UNREACHED_COST;
+		Parents[Index] = INDEX_NONE;
+		OpenIndices[Index] = INDEX_NONE;
+		Closed[Index] = false;
+	}
+
+	int32 GetGCost(int32 Index) const
+	{
+		return IsReached(Index) ? GCosts[Index] : UNREACHED_COST;
+	}
+
+	bool IsClosed(int32 Index) const
+	{
+		return IsReached(Index) && Closed[Index];
+	}
+
+	// Only meaningful for cells reached by the current search. A cell's open index is its place in the open list
+	// while it is in it.
+	TArray<int32> GCosts;
+	TArray<int32> Parents;
+	TArray<int32> OpenIndices;
+	TBitArray<> Closed;
+
+private:
+
+	TArray<uint32> SearchStamps;
+	uint32 CurrentSearch;
+};
+
+// Precomputed jump point search distances, for every cell of a grid and each of the eight directions. A positive
+// distance is how many steps reach the next jump point, anything else is minus how many steps reach a wall.
+struct FJumpDistances
+{
+public:
+	static constexpr int32 NUM_DIRECTIONS = 8;
+
+	TArray<int32> Distances;
+
+	int32 Get(int32 Cell, int32 Direction) const
+	{
+		return Distances[Cell * NUM_DIRECTIONS + Direction];
+	}
+};
+
+// A* open list as a binary min-heap on f cost. The search state keeps each open cell's place in the heap, so checking
+// whether a cell is open is a read and lowering its cost is a sift up rather than a search.
+class FPathOpenList
+{
+public:
+
+	explicit FPathOpenList(FPathSearchState& InSearch)
+		: Search(InSearch)
+	{
+	}
+
+	// Cells left in the list keep their open index, which the next search stamps over
+	void Reset()
 	{
-		for (uint32 X = 0; X < Length; X++)
+		Heap.Reset();
+	}
+
+	bool IsEmpty() const
+	{
+		return Heap.Num() == 0;
+	}
+
+	bool Contains(int32 Cell) const
+	{
+		return Search.IsReached(Cell) && Search.OpenIndices[Cell] != INDEX_NONE;
+	}
+
+	void Push(int32 Cell, int32 HCost)
+	{
+		SiftUp(Heap.Add({ Search.GCosts[Cell] + HCost, HCost, Cell }));
+	}
+
+	// Call after lowering the g cost of a cell that is already open
+	void DecreaseKey(int32 Cell)
+	{
+		const int32 Position = Search.OpenIndices[Cell];
+		Heap[Position].FCost = Search.GCosts[Cell] + Heap[Position].HCost;
+		SiftUp(Position);
+	}
+
+	// Removes and returns the cell with the lowest f cost, or INDEX_NONE if the list is empty
+	int32 Pop()
+	{
+		if (Heap.Num() == 0) return INDEX_NONE;
+
+		const int32 Cell = Heap[0].Cell;
+		Search.OpenIndices[Cell] = INDEX_NONE;
+		const FOpenCell Last = Heap.Pop(false);
+		if (Heap.Num() > 0)
 		{
-			delete[] Arr[X];
+			Heap[0] = Last;
+			SiftDown(0);
 		}
-		delete[] Arr;
+		return Cell;
 	}
 
-	int32 GetLength(uint8 Axis) const
+private:
+
+	// Costs are kept in the heap itself so sifting never reads the search state
+	struct FOpenCell
 	{
-		return Axis == 0 ? Length : Width;
+		int32 FCost;
+		int32 HCost;
+		int32 Cell;
+	};
+
+	FPathSearchState& Search;
+	TArray<FOpenCell> Heap;
+
+	// Ties go to the cell nearer the goal, which keeps the search heading for it across open ground
+	static bool IsLess(const FOpenCell& A, const FOpenCell& B)
+	{
+		return A.FCost < B.FCost || (A.FCost == B.FCost && A.HCost < B.HCost);
+	}
+
+	void SiftUp(int32 Position)
+	{
+		const FOpenCell Open = Heap[Position];
+		while (Position > 0)
+		{
+			const int32 Parent = (Position - 1) / 2;
+			if (!IsLess(Open, Heap[Parent])) break;
+
+			Heap[Position] = Heap[Parent];
+			Search.OpenIndices[Heap[Position].Cell] = Position;
+			Position = Parent;
+		}
+		Heap[Position] = Open;
+		Search.OpenIndices[Open.Cell] = Position;
 	}
 
-	FPathCell* operator[](uint32 const& X) const
+	void SiftDown(int32 Position)
 	{
-		return Arr[X];
+		const FOpenCell Open = Heap[Position];
+		while (true)
+		{
+			int32 Child = Position * 2 + 1;
+			if (Child >= Heap.Num()) break;
+			if (Child + 1 < Heap.Num() && IsLess(Heap[Child + 1], Heap[Child])) Child++;
+			if (!IsLess(Heap[Child], Open)) break;
+
+			Heap[Position] = Heap[Child];
+			Search.OpenIndices[Heap[Position].Cell] = Position;
+			Position = Child;
+		}
+		Heap[Position] = Open;
+		Search.OpenIndices[Open.Cell] = Position;
 	}
 };
 
@@ -229,6 +675,10 @@ public:
 	UPROPERTY(EditAnywhere)
 		FLayoutRules LayoutRules;
 
+	// Rules asset to generate from instead of LayoutRules. Its rules are compiled once when it loads.
+	UPROPERTY(EditAnywhere)
+		TObjectPtr<ULayoutRulesData> LayoutRulesData;
+
 	UPROPERTY(EditAnywhere)
 		int32 Width;
 
@@ -247,6 +697,35 @@ public:
 	UPROPERTY(EditAnywhere, meta=(ClampMin="0", ClampMax="1"))
 		float AdditionalCorridorChance;
 
+	// How many times room typing may undo a room type choice before giving up on the attempt and starting over
+	UPROPERTY(EditAnywhere, meta=(ClampMin="0"))
+		int32 MaxRoomTypingBacktracks;
+
+	// How many seeded room typing attempts run at once on the task graph. The lowest attempt that succeeds is always
+	// used, so the layout doesn't depend on this.
+	UPROPERTY(EditAnywhere, meta=(ClampMin="1"))
+		int32 ParallelRoomTypingAttempts;
+
+	// Triangulate room points in strips on worker threads. Only layouts with thousands of rooms are split, smaller
+	// ones triangulate serially either way. Rooms sharing a circle can end up linked differently than serially.
+	UPROPERTY(EditAnywhere, AdvancedDisplay)
+		bool bParallelTriangulation;
+
+	UPROPERTY(EditAnywhere)
+		ERoomSizingMode RoomSizingMode;
+
+	UPROPERTY(EditAnywhere)
+		ECorridorSearchMode CorridorSearchMode;
+
+	// How many corridor searches run at once on the task graph, or 0 for one per task graph worker thread. Every link
+	// is routed the same way whichever worker takes it, so the corridors don't depend on this.
+	UPROPERTY(EditAnywhere, meta=(ClampMin="0"))
+		int32 ParallelCorridorSearches;
+
+	// Lay the corridor pathfinding grid out in small square tiles instead of rows, so searches stay in cache
+	UPROPERTY(EditAnywhere, AdvancedDisplay)
+		bool bTilePathGrid;
+
 	UPROPERTY(EditAnywhere)
 		bool bDebug;
 
@@ -255,18 +734,28 @@ public:
 
 private:
 
-	TArray<FDEdge> Corridors;
 	TArray<FRoomData> CachedRoomDataCollection;
 
-	void PlacePoints(TArray<FDPoint>& Points);
-	void TriangulateLinks(TArray<FDPoint>& Points, OUT TMap<FDPoint, TArray<FDPoint>>& Adjacencies);
-	void DetermineRoomTypes(const TMap<FDPoint, TArray<FDPoint>>& Adjacencies, OUT TArray<FRoomData>& RoomDataCollection);
-	bool CollapseNeighbours(FRoomTile& Tile, uint8& bCollapsed);
-	bool ForcePlaceRoom(ERoomType RoomType, TArray<FRoomTile>& RoomTiles, uint8& CollapsedRooms, uint8& CollapsedIndex);
+	// The rules generation reads from, compiled from LayoutRulesData when it is set and from LayoutRules otherwise
+	FCompiledLayoutRules CompiledLayoutRules;
+
+	void CompileLayoutRules();
+	int32 PlacePoints(TArray<FDPoint>& Points);
+	bool TriangulateLinks(TArray<FDPoint>& Points, OUT FRoomGraph& RoomGraph);
+	void DetermineRoomTypes(const TArray<FDPoint>& Points, FRoomGraph& RoomGraph, OUT TArray<FRoomData>& RoomDataCollection);
+	bool TypeRooms(FRoomTypingState& State, const FRoomGraph& RoomGraph, int32 AttemptIndex, int32 Seed) const;
+	bool PlaceMandatoryRooms(FRoomTypingState& State) const;
+	bool CollapseRooms(FRoomTypingState& State) const;
+	void SetTileDomain(FRoomTypingState& State, int32 TileIndex, FRoomTypeMask Domain, bool bCollapsed) const;
+	void RollbackTiles(FRoomTypingState& State, int32 TrailMark) const;
+	bool PropagateConstraints(FRoomTypingState& State, int32 TileIndex) const;
+	bool PropagateConstraints(FRoomTypingState& State, TConstArrayView<int32> TileIndices) const;
+	bool ForcePlaceRoom(ERoomType RoomType, FRoomTypingState& State, int32& CollapsedIndex) const;
 	void SizeRooms(TArray<FRoomData>& RoomDataCollection);
+	bool PushRoomsApart(TArray<FRoomData>& RoomDataCollection);
+	void PackRooms(TArray<FRoomData>& RoomDataCollection);
 	bool MoveRoomOnGrid(FRoomData& Tile, FIntPoint NewGridPos);
 	int32 RoundToOdd(int32 Value);
-	bool IsRoomsConnected(const TArray<FRoomTile>& Rooms);
-	void BuildLinks(TArray<FRoomData>& Rooms);
-	void PopulateLinkPath(FLinkData& Link, Grid& Grid);
+	void BuildLinks(TArray<FRoomData>& Rooms, const FRoomGraph& RoomGraph);
+	void PopulateLinkPath(FLinkData& Link, const Grid& PathGrid, const FJumpDistances& JumpDistances, FPathSearchState& Search) const;
 };